@@ -0,0 +1,114 @@
+#pragma once
+
+#include "compact_optional.h"
+#include "wise_enum.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace wise_enum {
+
+/*
+  An atomic compact_optional: "some enumerator, or nothing" in a single
+  std::atomic of the underlying type, using the same sentinel as
+  compact_optional (picked at compile time by default, statically checked not
+  to be an enumerator). Unlike std::atomic<std::optional<T>>, there is no
+  separate flag, so it is lock free wherever the underlying type is.
+
+  Values are loaded and stored as compact_optional<T, invalid>; the interface
+  otherwise mirrors std::atomic.
+ */
+template <class T, std::underlying_type_t<T> invalid =
+                       detail::find_sentinel<T>().value>
+class atomic_compact_optional {
+  static_assert(is_wise_enum_v<T>,
+                "atomic_compact_optional is only for wise enum types");
+
+  using integral_type = std::underlying_type_t<T>;
+
+#if __cplusplus >= 201703L
+  static_assert(std::atomic<integral_type>::is_always_lock_free,
+                "atomic_compact_optional requires lock free atomics of the "
+                "underlying type");
+#endif
+
+public:
+  using value_type = compact_optional<T, invalid>;
+
+  // Empty
+  atomic_compact_optional() noexcept : m_storage(invalid) {}
+  atomic_compact_optional(value_type o) noexcept : m_storage(encode(o)) {}
+
+  atomic_compact_optional(const atomic_compact_optional &) = delete;
+  atomic_compact_optional &operator=(const atomic_compact_optional &) = delete;
+
+  value_type operator=(value_type o) noexcept {
+    store(o);
+    return o;
+  }
+  operator value_type() const noexcept { return load(); }
+
+  bool is_lock_free() const noexcept { return m_storage.is_lock_free(); }
+
+  value_type
+  load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+    return decode(m_storage.load(order));
+  }
+
+  void store(value_type o,
+             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    m_storage.store(encode(o), order);
+  }
+
+  void reset(std::memory_order order = std::memory_order_seq_cst) noexcept {
+    m_storage.store(invalid, order);
+  }
+
+  value_type
+  exchange(value_type o,
+           std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return decode(m_storage.exchange(encode(o), order));
+  }
+
+  bool compare_exchange_weak(
+      value_type &expected, value_type desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    auto e = encode(expected);
+    const auto result =
+        m_storage.compare_exchange_weak(e, encode(desired), order);
+    expected = decode(e);
+    return result;
+  }
+
+  bool compare_exchange_strong(
+      value_type &expected, value_type desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    auto e = encode(expected);
+    const auto result =
+        m_storage.compare_exchange_strong(e, encode(desired), order);
+    expected = decode(e);
+    return result;
+  }
+
+#if defined(__cpp_lib_atomic_wait)
+  void wait(value_type old,
+            std::memory_order order = std::memory_order_seq_cst) const
+      noexcept {
+    m_storage.wait(encode(old), order);
+  }
+  void notify_one() noexcept { m_storage.notify_one(); }
+  void notify_all() noexcept { m_storage.notify_all(); }
+#endif
+
+private:
+  static integral_type encode(value_type o) noexcept {
+    return o.has_value() ? static_cast<integral_type>(*o) : invalid;
+  }
+  static value_type decode(integral_type i) noexcept {
+    return i == invalid ? value_type{} : value_type{static_cast<T>(i)};
+  }
+
+  std::atomic<integral_type> m_storage;
+};
+
+} // namespace wise_enum
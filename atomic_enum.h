@@ -0,0 +1,147 @@
+#pragma once
+
+#include "enum_set.h"
+#include "wise_enum.h"
+
+#include <atomic>
+#include <cassert>
+#include <type_traits>
+
+namespace wise_enum {
+
+/*
+  An atomic wise enum, stored as a std::atomic of its underlying type, so it is
+  lock free wherever that is. The interface mirrors std::atomic, plus
+  transition, for state machines: it moves to a new state only if the current
+  state is in a set of allowed states, in a single compare and exchange loop.
+
+  In debug builds (NDEBUG not defined), every value written is asserted to be
+  an enumerator.
+ */
+template <class T>
+class atomic_enum {
+  static_assert(is_wise_enum_v<T>, "atomic_enum is only for wise enum types");
+
+  using integral_type = std::underlying_type_t<T>;
+
+#if __cplusplus >= 201703L
+  static_assert(std::atomic<integral_type>::is_always_lock_free,
+                "atomic_enum requires lock free atomics of the underlying "
+                "type");
+#endif
+
+public:
+  using value_type = T;
+
+  // Holds the first enumerator
+  atomic_enum() noexcept : atomic_enum(range<T>[0].value) {}
+  atomic_enum(T t) noexcept : m_storage(checked(t)) {}
+
+  atomic_enum(const atomic_enum &) = delete;
+  atomic_enum &operator=(const atomic_enum &) = delete;
+
+  T operator=(T t) noexcept {
+    store(t);
+    return t;
+  }
+  operator T() const noexcept { return load(); }
+
+  bool is_lock_free() const noexcept { return m_storage.is_lock_free(); }
+
+  T load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+    return static_cast<T>(m_storage.load(order));
+  }
+
+  void store(T t,
+             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    m_storage.store(checked(t), order);
+  }
+
+  T exchange(T t,
+             std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return static_cast<T>(m_storage.exchange(checked(t), order));
+  }
+
+  bool compare_exchange_weak(
+      T &expected, T desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    auto e = static_cast<integral_type>(expected);
+    const auto result =
+        m_storage.compare_exchange_weak(e, checked(desired), order);
+    expected = static_cast<T>(e);
+    return result;
+  }
+
+  bool compare_exchange_strong(
+      T &expected, T desired,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    auto e = static_cast<integral_type>(expected);
+    const auto result =
+        m_storage.compare_exchange_strong(e, checked(desired), order);
+    expected = static_cast<T>(e);
+    return result;
+  }
+
+  /*
+    Atomically replaces the current state by to, if the current state is a
+    member of from. Returns whether it did; either way, current is set to the
+    state that was observed (i.e. the state just before the transition on
+    success).
+   */
+  bool transition(
+      const enum_set<T> &from, T to, T &current,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    auto c = m_storage.load(std::memory_order_relaxed);
+    const auto desired = checked(to);
+    for (;;) {
+      if (!from.contains(static_cast<T>(c))) {
+        // Make the failed observation as strong as a successful one would be
+        c = m_storage.load(load_order(order));
+        if (!from.contains(static_cast<T>(c))) {
+          current = static_cast<T>(c);
+          return false;
+        }
+      }
+      if (m_storage.compare_exchange_weak(c, desired, order,
+                                          load_order(order))) {
+        current = static_cast<T>(c);
+        return true;
+      }
+    }
+  }
+
+  bool transition(
+      const enum_set<T> &from, T to,
+      std::memory_order order = std::memory_order_seq_cst) noexcept {
+    T current;
+    return transition(from, to, current, order);
+  }
+
+#if defined(__cpp_lib_atomic_wait)
+  void wait(T old, std::memory_order order = std::memory_order_seq_cst) const
+      noexcept {
+    m_storage.wait(static_cast<integral_type>(old), order);
+  }
+  void notify_one() noexcept { m_storage.notify_one(); }
+  void notify_all() noexcept { m_storage.notify_all(); }
+#endif
+
+private:
+  static integral_type checked(T t) noexcept {
+    assert(index_of(t) != size<T> && "Error, not an enumerator");
+    return static_cast<integral_type>(t);
+  }
+
+  // The strongest ordering valid for a load, given the ordering of an update
+  static constexpr std::memory_order load_order(std::memory_order order) {
+    return order == std::memory_order_acq_rel
+               ? std::memory_order_acquire
+               : order == std::memory_order_release
+                     ? std::memory_order_relaxed
+                     : order;
+  }
+
+  std::atomic<integral_type> m_storage;
+};
+
+} // namespace wise_enum
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "enum_set.h"
+#include "wise_enum.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace wise_enum {
+
+/*
+  An enum_set that can be updated concurrently without locks. It's stored as
+  one std::atomic<uint64_t> per 64 enumerators, with the same bit layout as
+  enum_set. Inserting or erasing a single enumerator is a single fetch_or or
+  fetch_and on one word, and tells whether the set actually changed, so it can
+  be used to claim a flag.
+
+  Operations involving several enumerators (inserting a whole enum_set,
+  snapshot, ...) are atomic word by word; for enums with at most 64 enumerators
+  this means they are atomic, period.
+
+  In 20, waiting is supported as well: wait_any blocks until one of a set of
+  enumerators is present. As with std::atomic, writers must call notify_all
+  after updating to wake waiters.
+ */
+template <class T>
+class atomic_enum_set {
+  static_assert(is_wise_enum_v<T>,
+                "atomic_enum_set is only for wise enum types");
+#if __cplusplus >= 201703L
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "atomic_enum_set requires lock free 64 bit atomics");
+#endif
+
+  static constexpr std::size_t num_enumerators = ::wise_enum::size<T>;
+  static constexpr std::size_t bits = 64;
+  static constexpr std::size_t word_count = enum_set<T>::words();
+
+public:
+  using value_type = T;
+
+  atomic_enum_set() noexcept {
+    for (auto &w : m_words)
+      w.store(0, std::memory_order_relaxed);
+  }
+
+  explicit atomic_enum_set(const enum_set<T> &s) noexcept {
+    for (std::size_t w = 0; w != word_count; ++w)
+      m_words[w].store(s.word(w), std::memory_order_relaxed);
+  }
+
+  atomic_enum_set(const atomic_enum_set &) = delete;
+  atomic_enum_set &operator=(const atomic_enum_set &) = delete;
+
+  // Returns true if t wasn't a member already
+  bool insert(T t, std::memory_order order = std::memory_order_seq_cst) {
+    const auto i = index_of(t);
+    if (i == num_enumerators)
+      return false;
+    const auto bit = std::uint64_t(1) << (i % bits);
+    return !(m_words[i / bits].fetch_or(bit, order) & bit);
+  }
+
+  // Returns true if t was a member
+  bool erase(T t, std::memory_order order = std::memory_order_seq_cst) {
+    const auto i = index_of(t);
+    if (i == num_enumerators)
+      return false;
+    const auto bit = std::uint64_t(1) << (i % bits);
+    return m_words[i / bits].fetch_and(~bit, order) & bit;
+  }
+
+  bool contains(T t,
+                std::memory_order order = std::memory_order_seq_cst) const {
+    const auto i = index_of(t);
+    return i != num_enumerators &&
+           ((m_words[i / bits].load(order) >> (i % bits)) & 1);
+  }
+
+  // Inserts all members of s; returns the members that were not present
+  // before
+  enum_set<T> insert(const enum_set<T> &s,
+                     std::memory_order order = std::memory_order_seq_cst) {
+    enum_set<T> added;
+    for (std::size_t w = 0; w != word_count; ++w) {
+      if (s.word(w) != 0) {
+        const auto old = m_words[w].fetch_or(s.word(w), order);
+        added.set_word(w, ~old & s.word(w));
+      }
+    }
+    return added;
+  }
+
+  // Erases all members of s; returns the members that were present before
+  enum_set<T> erase(const enum_set<T> &s,
+                    std::memory_order order = std::memory_order_seq_cst) {
+    enum_set<T> removed;
+    for (std::size_t w = 0; w != word_count; ++w) {
+      if (s.word(w) != 0) {
+        const auto old = m_words[w].fetch_and(~s.word(w), order);
+        removed.set_word(w, old & s.word(w));
+      }
+    }
+    return removed;
+  }
+
+  // True if any member of s is present
+  bool any_of(const enum_set<T> &s,
+              std::memory_order order = std::memory_order_seq_cst) const {
+    for (std::size_t w = 0; w != word_count; ++w) {
+      if (s.word(w) != 0 && (m_words[w].load(order) & s.word(w)) != 0)
+        return true;
+    }
+    return false;
+  }
+
+  enum_set<T> snapshot(
+      std::memory_order order = std::memory_order_seq_cst) const {
+    enum_set<T> s;
+    for (std::size_t w = 0; w != word_count; ++w)
+      s.set_word(w, m_words[w].load(order));
+    return s;
+  }
+
+  void clear(std::memory_order order = std::memory_order_seq_cst) {
+    for (auto &w : m_words)
+      w.store(0, order);
+  }
+
+#if defined(__cpp_lib_atomic_wait)
+  // Blocks until any member of s is present
+  void wait_any(const enum_set<T> &s) const {
+    for (;;) {
+      const auto epoch = m_epoch.load();
+      if (any_of(s))
+        return;
+      m_epoch.wait(epoch);
+    }
+  }
+
+  // Wakes up all threads blocked in wait_any, so they can recheck the set
+  void notify_all() {
+    m_epoch.fetch_add(1);
+    m_epoch.notify_all();
+  }
+#endif
+
+private:
+  std::atomic<std::uint64_t> m_words[word_count];
+#if defined(__cpp_lib_atomic_wait)
+  // Waiting happens on this counter rather than on the words themselves, so
+  // that a waiter can't miss an update to a word other than the one it waits
+  // on
+  std::atomic<std::uint32_t> m_epoch{0};
+#endif
+};
+
+} // namespace wise_enum
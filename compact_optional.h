@@ -3,6 +3,7 @@
 #include "optional.h" // only for exception, consider refactoring
 #include "wise_enum.h"
 
+#include <limits>
 #include <type_traits>
 
 namespace wise_enum {
@@ -19,6 +20,80 @@ constexpr bool is_enum_value(std::underlying_type_t<T> enum_integral) {
   return false;
 }
 
+namespace detail {
+
+// Scoped enums always have a fixed underlying type. Unscoped ones may or may
+// not; in 17 the ones that do could be told apart, but not in 14, so they are
+// all assumed not to have one. The rule must not depend on the standard, or
+// the default sentinel, and so the type of a compact_optional, would differ
+// between 14 and 17 translation units.
+template <class T>
+struct has_fixed_underlying_type
+    : std::integral_constant<
+          bool, !std::is_convertible<T, std::underlying_type_t<T>>::value> {};
+
+// All bits below and including the highest set bit of v
+template <class U>
+constexpr U smear(U v) {
+  for (std::size_t shift = 1; shift < sizeof(U) * 8; shift *= 2)
+    v |= v >> shift;
+  return v;
+}
+
+template <class U>
+struct value_interval {
+  U min;
+  U max;
+};
+
+// The values an enum can legally hold: the whole underlying type if it is
+// fixed, otherwise the values of the smallest bit-field that fits every
+// enumerator
+template <class T>
+constexpr value_interval<std::underlying_type_t<T>> valid_values() {
+  using U = std::underlying_type_t<T>;
+  if (has_fixed_underlying_type<T>::value)
+    return {std::numeric_limits<U>::min(), std::numeric_limits<U>::max()};
+  const U lo = min_value<T>();
+  const U hi = max_value<T>();
+  if (lo >= 0)
+    return {0, static_cast<U>(smear(hi) | 1)};
+  // Two's complement bit-field: the magnitude of lo is ~lo + 1
+  const auto neg = static_cast<U>(~lo);
+  const U m = smear(hi > neg ? hi : neg);
+  return {static_cast<U>(~m), m};
+}
+
+template <class U>
+struct sentinel_search {
+  bool found;
+  U value;
+};
+
+// The largest value of the underlying type if it isn't an enumerator, which
+// was always the default, so that existing compact_optionals keep their type
+// and encoding. Otherwise, the largest valid value that isn't an enumerator:
+// out of any size<T> + 1 distinct values at least one is free, so only that
+// many are looked at.
+template <class T>
+constexpr sentinel_search<std::underlying_type_t<T>> find_sentinel() {
+  using U = std::underlying_type_t<T>;
+  if (!is_enum_value<T>(std::numeric_limits<U>::max()))
+    return {true, std::numeric_limits<U>::max()};
+  const auto r = valid_values<T>();
+  auto v = r.max;
+  for (std::size_t i = 0; i <= size<T>; ++i) {
+    if (!is_enum_value<T>(v))
+      return {true, v};
+    if (v == r.min)
+      break;
+    v = static_cast<decltype(v)>(v - 1);
+  }
+  return {false, r.max};
+}
+
+} // namespace detail
+
 /*
   Implementation note: this doesn't exactly implement the subset of the optional
   interface correctly, in particular operator* and value return by value. This
@@ -41,17 +116,34 @@ constexpr bool is_enum_value(std::underlying_type_t<T> enum_integral) {
   behavior and normal optional will mostly be caught at compile time (e.g. *foo
   = MyEnum::BAR will not compile for compact optional). None of the
   discrepancies are critical to usage.
+
+   By default the sentinel is the largest value of the underlying type; as it's
+  only ever stored in an integral_type, it doesn't matter whether the enum can
+  hold it. Only if that value is an enumerator is another one picked at
+  compile time: the largest value that isn't an enumerator and that the enum
+  can legally hold. That is, within the whole underlying type for enum
+  classes, and within the bitset range above for unscoped enums, even those
+  with explicit storage (they can't be told apart in 14, and the choice must
+  be the same in every standard). If there is none, compilation fails.
  */
 template <class T, std::underlying_type_t<T> invalid =
-                       std::numeric_limits<std::underlying_type_t<T>>::max()>
+                       detail::find_sentinel<T>().value>
 class compact_optional {
 
   using integral_type = std::underlying_type_t<T>;
 
   static_assert(is_wise_enum_v<T>,
                 "wise enum compact_optional is only for wise enum types");
+  // True if invalid is the default, and there was no sentinel to pick
+  static constexpr bool no_sentinel = !detail::find_sentinel<T>().found &&
+                                      invalid == detail::find_sentinel<T>().value;
+
+  static_assert(!no_sentinel,
+                "Error, every value this enum can hold is an enumerator, so "
+                "there is no sentinel for compact_optional to use; consider "
+                "compact_ordinal_optional");
   static_assert(
-      !is_enum_value<T>(invalid),
+      no_sentinel || !is_enum_value<T>(invalid),
       "Error, can't use this invalid value as it is taken by an enumerator");
 
 public:
@@ -92,4 +184,70 @@ private:
   integral_type m_storage = invalid;
 };
 
+/*
+  A compact optional that doesn't store the enum itself, but its ordinal (its
+  index in range<T>), in the smallest unsigned integral type that fits
+  size<T> + 1 values; the extra value, size<T>, means empty. An enum with 64
+  bit storage but less than 256 enumerators thus takes a single byte.
+  Conversion in either direction is a table lookup.
+
+  Unlike compact_optional, no sentinel needs to be chosen, but only
+  enumerators can be stored: constructing it from any other value results in
+  an empty optional. The same caveats as for compact_optional apply to the
+  interface (operator* and value return by value).
+ */
+template <class T>
+class compact_ordinal_optional {
+
+  using storage_type = detail::smallest_uint_t<size<T>>;
+
+  static_assert(
+      is_wise_enum_v<T>,
+      "wise enum compact_ordinal_optional is only for wise enum types");
+
+  static constexpr storage_type empty = size<T>;
+
+public:
+  compact_ordinal_optional() = default;
+
+  constexpr compact_ordinal_optional(T t)
+      : m_storage(static_cast<storage_type>(index_of(t))) {}
+
+  constexpr T operator*() const {
+    return detail::value_table<T>::values[m_storage];
+  }
+
+  constexpr bool has_value() const noexcept { return m_storage != empty; }
+  constexpr explicit operator bool() const noexcept {
+    return m_storage != empty;
+  }
+
+  constexpr T value() const {
+    if (m_storage != empty)
+      return detail::value_table<T>::values[m_storage];
+    else
+      throw bad_optional_access{};
+  }
+
+  template <class U>
+  constexpr T value_or(U &&u) const {
+    if (has_value())
+      return detail::value_table<T>::values[m_storage];
+    else
+      return std::forward<U>(u);
+  }
+
+  void reset() noexcept { m_storage = empty; }
+
+  compact_ordinal_optional(const compact_ordinal_optional &other) = default;
+  compact_ordinal_optional(compact_ordinal_optional &&other) = default;
+  compact_ordinal_optional &
+  operator=(const compact_ordinal_optional &other) = default;
+  compact_ordinal_optional &
+  operator=(compact_ordinal_optional &&other) = default;
+
+private:
+  storage_type m_storage = empty;
+};
+
 } // namespace wise_enum
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace wise_enum {
+
+template <class E, class Sig>
+class dispatch_table;
+
+/*
+  A table of function pointers with one slot per enumerator, indexed by
+  ordinal, so that dispatching on an enum is a single indirect call with no
+  switch. The table is generated at compile time from a class template with a
+  static member function call, instantiated for every enumerator:
+
+    template <MsgType M>
+    struct on_message {
+      static void call(const char *payload) { ... }
+    };
+
+    using table = wise_enum::dispatch_table<MsgType, void(const char *)>;
+    constexpr auto handlers = table::make<on_message>();
+    handlers(msg_type, payload);
+
+  A copy of the table can have its slots overridden at runtime, e.g. by
+  plugins. Values that aren't enumerators go to a fallback slot, which by
+  default throws std::out_of_range, and can be overridden as well.
+ */
+template <class E, class R, class... Args>
+class dispatch_table<E, R(Args...)> {
+  static_assert(is_wise_enum_v<E>,
+                "dispatch_table is only for wise enum types");
+
+  static constexpr std::size_t num_enumerators = ::wise_enum::size<E>;
+
+public:
+  using function_type = R (*)(Args...);
+
+  template <template <E> class Handler>
+  static constexpr dispatch_table make() {
+    return make<Handler>(std::make_index_sequence<num_enumerators>{});
+  }
+
+  R operator()(E e, Args... args) const {
+    return m_table[index_of(e)](std::forward<Args>(args)...);
+  }
+
+  // The function called for e, or the fallback if e isn't an enumerator
+  constexpr function_type get(E e) const { return m_table[index_of(e)]; }
+
+  // Replaces the function called for e, returning the previous one
+  function_type set(E e, function_type f) {
+    const auto i = index_of(e);
+    if (i == num_enumerators)
+      throw std::out_of_range("Error, dispatch_table key is not an enumerator");
+    const auto previous = m_table[i];
+    m_table[i] = f;
+    return previous;
+  }
+
+  // Replaces the function called for non enumerators, returning the previous
+  // one
+  function_type set_fallback(function_type f) {
+    const auto previous = m_table[num_enumerators];
+    m_table[num_enumerators] = f;
+    return previous;
+  }
+
+private:
+  template <template <E> class Handler, std::size_t... I>
+  static constexpr dispatch_table make(std::index_sequence<I...>) {
+    return dispatch_table{
+        {{&Handler<detail::value_table<E>::values[I]>::call...,
+          &not_an_enumerator}}};
+  }
+
+  static R not_an_enumerator(Args...) {
+    throw std::out_of_range("Error, dispatched value is not an enumerator");
+  }
+
+  constexpr dispatch_table(
+      const detail::constexpr_array<function_type, num_enumerators + 1> &table)
+      : m_table(table) {}
+
+  detail::constexpr_array<function_type, num_enumerators + 1> m_table;
+};
+
+} // namespace wise_enum
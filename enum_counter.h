@@ -0,0 +1,104 @@
+#pragma once
+
+#include "enum_map.h"
+#include "wise_enum.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace wise_enum {
+namespace detail {
+
+// Small id for the calling thread, assigned on first use; used to spread
+// threads over shards
+inline std::size_t thread_shard_id() {
+  static std::atomic<std::size_t> next{0};
+  thread_local const std::size_t id =
+      next.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+constexpr std::size_t cache_line_size = 64;
+
+} // namespace detail
+
+/*
+  A counter per enumerator, for counting events from many threads. A single
+  set of shared atomic counters scales badly, as every increment bounces the
+  cache line between cores. Instead, counts are sharded: each thread is
+  assigned one of Shards slabs of counters (round robin, on first use), and
+  each slab sits on its own cache lines. As long as there are no more threads
+  than shards, increments never contend; beyond that they remain correct, just
+  shared between a few threads. Increments are relaxed atomic additions, with
+  no locks.
+
+  snapshot() sums all slabs into an enum_map, in declared order. It is not a
+  consistent cut with respect to concurrent increments; each counter is
+  individually exact as of some point during the call.
+
+  The slabs are stored in the object itself, aligned to cache lines; it's meant
+  to live in static storage or as a member of a long lived object. Its size is
+  roughly Shards * size<T> * 8 bytes, rounded up to cache lines. Increments of
+  values that aren't enumerators are ignored.
+ */
+template <class T, std::size_t Shards = 16>
+class enum_counter {
+  static_assert(is_wise_enum_v<T>, "enum_counter is only for wise enum types");
+  static_assert(Shards != 0, "Error, need at least one shard");
+
+  static constexpr std::size_t num_enumerators = ::wise_enum::size<T>;
+
+public:
+  enum_counter() noexcept { reset(); }
+
+  enum_counter(const enum_counter &) = delete;
+  enum_counter &operator=(const enum_counter &) = delete;
+
+  void increment(T t) noexcept { add(t, 1); }
+
+  void add(T t, std::uint64_t n) noexcept {
+    // Non enumerators go to an extra counter that is never read
+    auto &s = m_slabs[detail::thread_shard_id() % Shards];
+    s.counts[index_of(t)].fetch_add(n, std::memory_order_relaxed);
+  }
+
+  // Total count for a single enumerator
+  std::uint64_t get(T t) const noexcept {
+    const auto i = index_of(t);
+    if (i == num_enumerators)
+      return 0;
+    std::uint64_t total = 0;
+    for (const auto &s : m_slabs)
+      total += s.counts[i].load(std::memory_order_relaxed);
+    return total;
+  }
+
+  enum_map<T, std::uint64_t> snapshot() const noexcept {
+    enum_map<T, std::uint64_t> result;
+    auto &values = result.values();
+    for (const auto &s : m_slabs) {
+      for (std::size_t i = 0; i != num_enumerators; ++i)
+        values[i] += s.counts[i].load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  // Zeroes all counters. Increments concurrent with a reset may or may not be
+  // lost.
+  void reset() noexcept {
+    for (auto &s : m_slabs) {
+      for (auto &c : s.counts)
+        c.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  struct alignas(detail::cache_line_size) slab {
+    std::atomic<std::uint64_t> counts[num_enumerators + 1];
+  };
+
+  slab m_slabs[Shards];
+};
+
+} // namespace wise_enum
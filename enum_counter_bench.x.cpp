@@ -0,0 +1,65 @@
+#include "enum_counter.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Compares enum_counter against a single set of shared atomic counters, with
+// an increasing number of threads. Build with optimizations, e.g.
+//   g++ -std=c++14 -O2 -pthread enum_counter_bench.x.cpp
+
+WISE_ENUM_CLASS(Event, CONNECT, DISCONNECT, READ, WRITE, FAILURE)
+
+namespace {
+
+constexpr std::uint64_t increments_per_thread = 20000000;
+
+struct shared_counters {
+  std::atomic<std::uint64_t> counts[wise_enum::size<Event>] = {};
+  void increment(Event e) {
+    counts[wise_enum::index_of(e)].fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+template <class Counter>
+double run(Counter &counter, unsigned threads) {
+  std::vector<std::thread> workers;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned t = 0; t != threads; ++t) {
+    workers.emplace_back([&counter, t] {
+      for (std::uint64_t i = 0; i != increments_per_thread; ++i)
+        counter.increment(wise_enum::range<Event>[(i + t) % 5].value);
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  // nanoseconds per increment, per thread
+  return elapsed.count() * 1e9 / increments_per_thread;
+}
+
+} // namespace
+
+int main() {
+  static wise_enum::enum_counter<Event, 64> sharded;
+  static shared_counters shared;
+
+  const auto max_threads = std::thread::hardware_concurrency();
+  std::cout << "threads  shared(ns/op)  enum_counter(ns/op)\n";
+  for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    const auto s = run(shared, threads);
+    const auto e = run(sharded, threads);
+    std::cout << threads << "        " << s << "          " << e << "\n";
+  }
+
+  const auto counts = sharded.snapshot();
+  std::uint64_t total = 0;
+  for (auto p : counts)
+    total += p.second;
+  std::cout << "total increments: " << total << "\n";
+  return 0;
+}
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "enum_set.h"
+#include "wise_enum.h"
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace wise_enum {
+namespace detail {
+
+template <class E, class V>
+constexpr const V &find_mapped(std::initializer_list<std::pair<E, V>> init,
+                               E e) {
+  for (const auto &p : init) {
+    if (p.first == e)
+      return p.second;
+  }
+  // In a constant expression, this makes an incomplete initializer a
+  // compilation error
+  throw std::invalid_argument(
+      "Error, enum_map initializer is missing an enumerator");
+}
+
+// True if every enumerator has a distinct value
+template <class E>
+constexpr bool has_no_aliases() {
+  for (std::size_t i = 0; i != size<E>; ++i) {
+    if (!is_canonical_ordinal<E>(i))
+      return false;
+  }
+  return true;
+}
+
+// std::array's non const operator[] and data() are not constexpr until 17, but
+// its const operator[] is; mutating members of the maps go through this, so
+// that they are usable in constant expressions in 14
+template <class V, std::size_t N>
+constexpr V &mutable_at(std::array<V, N> &a, std::size_t i) {
+  return const_cast<V &>(static_cast<const std::array<V, N> &>(a)[i]);
+}
+
+template <class V, std::size_t N>
+constexpr bool array_equal(const std::array<V, N> &a,
+                           const std::array<V, N> &b) {
+  for (std::size_t i = 0; i != N; ++i) {
+    if (!(a[i] == b[i]))
+      return false;
+  }
+  return true;
+}
+
+// Iterates over the enumerators at the given indices, yielding (enumerator,
+// value) pairs
+template <class E, class V, class Indices>
+class enum_map_iterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = std::pair<E, V &>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = std::pair<E, V &>;
+
+  constexpr enum_map_iterator() = default;
+  constexpr enum_map_iterator(V *values, Indices it)
+      : m_values(values), m_it(it) {}
+
+  constexpr reference operator*() const {
+    const auto i = *m_it;
+    return {range<E>[i].value, m_values[i]};
+  }
+
+  constexpr enum_map_iterator &operator++() {
+    ++m_it;
+    return *this;
+  }
+  constexpr enum_map_iterator operator++(int) {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  friend constexpr bool operator==(const enum_map_iterator &a,
+                                   const enum_map_iterator &b) {
+    return a.m_it == b.m_it;
+  }
+  friend constexpr bool operator!=(const enum_map_iterator &a,
+                                   const enum_map_iterator &b) {
+    return !(a == b);
+  }
+
+private:
+  V *m_values = nullptr;
+  Indices m_it{};
+};
+
+// Visits every index in [0, size<E>)
+struct all_indices {
+  std::size_t i = 0;
+  constexpr std::size_t operator*() const { return i; }
+  constexpr all_indices &operator++() {
+    ++i;
+    return *this;
+  }
+  friend constexpr bool operator==(all_indices a, all_indices b) {
+    return a.i == b.i;
+  }
+};
+
+// Visits the indices of the members of an enum_set
+template <class E>
+struct set_indices {
+  typename enum_set<E>::iterator it;
+  constexpr std::size_t operator*() const { return index_of(*it); }
+  constexpr set_indices &operator++() {
+    ++it;
+    return *this;
+  }
+  friend constexpr bool operator==(set_indices a, set_indices b) {
+    return a.it == b.it;
+  }
+};
+
+} // namespace detail
+
+/*
+  A map from every enumerator of E to a V, stored as a std::array<V, size<E>>
+  indexed by index_of, so lookups are O(1) with no hashing or tree walking, and
+  iteration is in declared order, yielding (enumerator, value) pairs:
+
+    for (auto p : m) use(p.first, p.second);
+
+  It always holds a value for every enumerator. Constructing it from an
+  initializer list requires every enumerator to be present; in a constant
+  expression a missing one is a compilation error, otherwise it throws
+  std::invalid_argument. See partial_enum_map for maps that may lack keys.
+  Enums where two enumerators have the same value can't be keys.
+
+  Indexing with a value that isn't an enumerator is undefined behavior with
+  operator[], and throws std::out_of_range with at().
+ */
+template <class E, class V>
+class enum_map {
+  static_assert(is_wise_enum_v<E>, "enum_map is only for wise enum types");
+  static_assert(detail::has_no_aliases<E>(),
+                "Error, enum_map keys must have distinct values; two "
+                "enumerators with the same value would share one entry");
+
+  static constexpr std::size_t num_enumerators = ::wise_enum::size<E>;
+
+public:
+  using key_type = E;
+  using mapped_type = V;
+  using size_type = std::size_t;
+  using iterator = detail::enum_map_iterator<E, V, detail::all_indices>;
+  using const_iterator =
+      detail::enum_map_iterator<E, const V, detail::all_indices>;
+
+  constexpr enum_map() = default;
+
+  // Maps every enumerator to a copy of v
+  explicit constexpr enum_map(const V &v)
+      : enum_map(v, std::make_index_sequence<num_enumerators>{}) {}
+
+  constexpr enum_map(std::initializer_list<std::pair<E, V>> init)
+      : enum_map(init, std::make_index_sequence<num_enumerators>{}) {}
+
+  constexpr V &operator[](E e) {
+    return detail::mutable_at(m_values, index_of(e));
+  }
+  constexpr const V &operator[](E e) const { return m_values[index_of(e)]; }
+
+  constexpr V &at(E e) {
+    return detail::mutable_at(m_values, checked_index(e));
+  }
+  constexpr const V &at(E e) const { return m_values[checked_index(e)]; }
+
+  static constexpr std::size_t size() { return num_enumerators; }
+
+  constexpr iterator begin() { return {&detail::mutable_at(m_values, 0), {0}}; }
+  constexpr iterator end() {
+    return {&detail::mutable_at(m_values, 0), {num_enumerators}};
+  }
+  constexpr const_iterator begin() const { return {&m_values[0], {0}}; }
+  constexpr const_iterator end() const {
+    return {&m_values[0], {num_enumerators}};
+  }
+
+  // The values alone, in declared order of their keys
+  constexpr std::array<V, num_enumerators> &values() { return m_values; }
+  constexpr const std::array<V, num_enumerators> &values() const {
+    return m_values;
+  }
+
+  friend constexpr bool operator==(const enum_map &a, const enum_map &b) {
+    return detail::array_equal(a.m_values, b.m_values);
+  }
+  friend constexpr bool operator!=(const enum_map &a, const enum_map &b) {
+    return !(a == b);
+  }
+
+private:
+  template <std::size_t... I>
+  constexpr enum_map(const V &v, std::index_sequence<I...>)
+      : m_values{{(static_cast<void>(I), v)...}} {}
+
+  template <std::size_t... I>
+  constexpr enum_map(std::initializer_list<std::pair<E, V>> init,
+                     std::index_sequence<I...>)
+      : m_values{{detail::find_mapped(init, range<E>[I].value)...}} {}
+
+  static constexpr std::size_t checked_index(E e) {
+    const auto i = index_of(e);
+    if (i == num_enumerators)
+      throw std::out_of_range("Error, enum_map key is not an enumerator");
+    return i;
+  }
+
+  std::array<V, num_enumerators> m_values{};
+};
+
+/*
+  Like enum_map, but each enumerator may or may not be present, tracked by an
+  enum_set alongside the values. Lookups are still O(1); iteration only visits
+  present entries, in declared order. V must be default constructible, as
+  storage for absent entries still holds a default constructed V (erasing an
+  entry resets it). Inserting a key that isn't an enumerator is undefined
+  behavior; lookups simply report such keys as absent.
+ */
+template <class E, class V>
+class partial_enum_map {
+  static_assert(is_wise_enum_v<E>,
+                "partial_enum_map is only for wise enum types");
+  static_assert(detail::has_no_aliases<E>(),
+                "Error, partial_enum_map keys must have distinct values; two "
+                "enumerators with the same value would share one entry");
+
+  static constexpr std::size_t num_enumerators = ::wise_enum::size<E>;
+
+public:
+  using key_type = E;
+  using mapped_type = V;
+  using size_type = std::size_t;
+  using iterator = detail::enum_map_iterator<E, V, detail::set_indices<E>>;
+  using const_iterator =
+      detail::enum_map_iterator<E, const V, detail::set_indices<E>>;
+
+  constexpr partial_enum_map() = default;
+
+  constexpr partial_enum_map(std::initializer_list<std::pair<E, V>> init) {
+    for (const auto &p : init)
+      insert_or_assign(p.first, p.second);
+  }
+
+  constexpr bool contains(E e) const { return m_present.contains(e); }
+  constexpr std::size_t count(E e) const { return m_present.count(e); }
+
+  // Returns nullptr if e is not present
+  constexpr V *find(E e) {
+    return contains(e) ? &detail::mutable_at(m_values, index_of(e)) : nullptr;
+  }
+  constexpr const V *find(E e) const {
+    return contains(e) ? &m_values[index_of(e)] : nullptr;
+  }
+
+  // Inserts a default constructed value if e is not present
+  constexpr V &operator[](E e) {
+    m_present.insert(e);
+    return detail::mutable_at(m_values, index_of(e));
+  }
+
+  constexpr V &at(E e) {
+    if (!contains(e))
+      throw std::out_of_range("Error, key not present in partial_enum_map");
+    return detail::mutable_at(m_values, index_of(e));
+  }
+  constexpr const V &at(E e) const {
+    if (!contains(e))
+      throw std::out_of_range("Error, key not present in partial_enum_map");
+    return m_values[index_of(e)];
+  }
+
+  // Returns true if e was inserted, false if it was present and assigned
+  template <class U>
+  constexpr bool insert_or_assign(E e, U &&u) {
+    const auto inserted = m_present.insert(e);
+    detail::mutable_at(m_values, index_of(e)) = std::forward<U>(u);
+    return inserted;
+  }
+
+  constexpr std::size_t erase(E e) {
+    if (!m_present.erase(e))
+      return 0;
+    detail::mutable_at(m_values, index_of(e)) = V{};
+    return 1;
+  }
+
+  constexpr void clear() {
+    for (auto e : m_present)
+      detail::mutable_at(m_values, index_of(e)) = V{};
+    m_present.clear();
+  }
+
+  constexpr std::size_t size() const { return m_present.size(); }
+  constexpr bool empty() const { return m_present.empty(); }
+
+  // The set of keys present in the map
+  constexpr const enum_set<E> &keys() const { return m_present; }
+
+  constexpr iterator begin() {
+    return {&detail::mutable_at(m_values, 0), {m_present.begin()}};
+  }
+  constexpr iterator end() {
+    return {&detail::mutable_at(m_values, 0), {m_present.end()}};
+  }
+  constexpr const_iterator begin() const {
+    return {&m_values[0], {m_present.begin()}};
+  }
+  constexpr const_iterator end() const {
+    return {&m_values[0], {m_present.end()}};
+  }
+
+private:
+  std::array<V, num_enumerators> m_values{};
+  enum_set<E> m_present;
+};
+
+} // namespace wise_enum
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "visit.h"
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wise_enum {
+
+/*
+  A polymorphic object whose concrete type is chosen by an enumerator, stored
+  in place rather than on the heap. Mapping is a class template from
+  enumerators to types deriving from Base, e.g. the MyDerived<E> of
+
+    template <MyEnum E>
+    class MyDerived : public MyInterface {...};
+
+    wise_enum::enum_object<MyEnum, MyInterface, MyDerived> obj(e, args...);
+    obj->do_something();
+
+  The buffer is sized and aligned at compile time for the largest alternative,
+  so creating an object never allocates; the concrete type is picked with
+  visit, a single jump through a table. emplace destroys the current object
+  and creates a new one in the same buffer, for reuse in loops.
+
+  Every alternative must be constructible from the arguments given (they are
+  all instantiated), and Base must have a virtual destructor. An enum_object
+  may be empty: when default constructed, after reset(), or when creating the
+  object threw (e.g. std::out_of_range, for a value that isn't an enumerator).
+  It can't be copied or moved.
+ */
+template <class E, class Base, template <E> class Mapping>
+class enum_object {
+  static_assert(is_wise_enum_v<E>, "enum_object is only for wise enum types");
+  static_assert(std::has_virtual_destructor<Base>::value,
+                "Error, enum_object requires a base with a virtual destructor");
+
+  using indices = std::make_index_sequence<size<E>>;
+
+  static_assert(
+      detail::all_mapped_derive_from<E, Base, Mapping>(indices{}),
+      "Error, every type mapped to by enum_object must derive from its base");
+
+public:
+  static constexpr std::size_t buffer_size =
+      detail::max_mapped_size<E, Mapping>(indices{});
+  static constexpr std::size_t buffer_alignment =
+      detail::max_mapped_alignment<E, Mapping>(indices{});
+
+  enum_object() noexcept = default;
+
+  template <class... Args>
+  explicit enum_object(E e, Args &&... args) {
+    emplace(e, std::forward<Args>(args)...);
+  }
+
+  enum_object(const enum_object &) = delete;
+  enum_object &operator=(const enum_object &) = delete;
+
+  ~enum_object() { reset(); }
+
+  template <class... Args>
+  Base &emplace(E e, Args &&... args) {
+    reset();
+    m_base = ::wise_enum::visit(e, [&](auto c) -> Base * {
+      return ::new (static_cast<void *>(m_buffer))
+          Mapping<decltype(c)::value>(std::forward<Args>(args)...);
+    });
+    m_kind = e;
+    return *m_base;
+  }
+
+  void reset() noexcept {
+    if (m_base) {
+      m_base->~Base();
+      m_base = nullptr;
+    }
+  }
+
+  bool has_value() const noexcept { return m_base != nullptr; }
+  explicit operator bool() const noexcept { return m_base != nullptr; }
+
+  // The enumerator the current object was created for
+  E kind() const noexcept { return m_kind; }
+
+  Base *get() noexcept { return m_base; }
+  const Base *get() const noexcept { return m_base; }
+  Base *operator->() noexcept { return m_base; }
+  const Base *operator->() const noexcept { return m_base; }
+  Base &operator*() noexcept { return *m_base; }
+  const Base &operator*() const noexcept { return *m_base; }
+
+private:
+  alignas(buffer_alignment) unsigned char m_buffer[buffer_size];
+  Base *m_base = nullptr;
+  E m_kind{};
+};
+
+} // namespace wise_enum
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+
+namespace wise_enum {
+namespace detail {
+
+// Bit i of word i / 64 is set if ordinal i is canonical, i.e. can be a member
+template <class T, std::size_t Words>
+constexpr constexpr_array<std::uint64_t, Words> make_canonical_words() {
+  constexpr_array<std::uint64_t, Words> a{};
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    if (is_canonical_ordinal<T>(i))
+      a[i / 64] |= std::uint64_t(1) << (i % 64);
+  }
+  return a;
+}
+
+template <class T, std::size_t Words>
+struct canonical_words {
+  static constexpr constexpr_array<std::uint64_t, Words> value =
+      make_canonical_words<T, Words>();
+};
+
+template <class T, std::size_t Words>
+constexpr constexpr_array<std::uint64_t, Words>
+    canonical_words<T, Words>::value;
+
+} // namespace detail
+
+/*
+  A set of enumerators of a wise enum, stored as a fixed size bitset with one
+  bit per enumerator, bit i standing for range<T>[i]. Because bits are indexed
+  by position rather than by value, enums with sparse values (e.g. bit flags,
+  or large explicit values) still only take size<T> bits.
+
+  Everything is constexpr. Set operations work a 64 bit word at a time; for
+  enums with more than 64 enumerators these are simple loops over the words
+  that compilers unroll and vectorize. Iteration visits enumerators in declared
+  order, jumping between set bits with count trailing zeros.
+
+  Values of T that aren't enumerators are never members: inserting them does
+  nothing. An enumerator with the same value as an earlier one is the same
+  member, so its bit is never set, not even in all().
+ */
+template <class T>
+class enum_set {
+  static_assert(is_wise_enum_v<T>, "enum_set is only for wise enum types");
+
+  static constexpr std::size_t num_enumerators = ::wise_enum::size<T>;
+  static constexpr std::size_t bits = 64;
+  static constexpr std::size_t word_count =
+      (num_enumerators + bits - 1) / bits;
+
+  // The bits that may be set in word w
+  static constexpr std::uint64_t word_mask(std::size_t w) {
+    return detail::canonical_words<T, word_count>::value[w];
+  }
+
+public:
+  using value_type = T;
+  using key_type = T;
+  using size_type = std::size_t;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = T;
+
+    constexpr iterator() = default;
+
+    constexpr T operator*() const { return range<T>[m_index].value; }
+
+    constexpr iterator &operator++() {
+      m_index = m_set->next(m_index + 1);
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    friend constexpr bool operator==(iterator a, iterator b) {
+      return a.m_index == b.m_index;
+    }
+    friend constexpr bool operator!=(iterator a, iterator b) {
+      return a.m_index != b.m_index;
+    }
+
+  private:
+    friend class enum_set;
+    constexpr iterator(const enum_set *s, std::size_t i)
+        : m_set(s), m_index(i) {}
+
+    const enum_set *m_set = nullptr;
+    std::size_t m_index = num_enumerators;
+  };
+  using const_iterator = iterator;
+
+  constexpr enum_set() = default;
+
+  constexpr enum_set(std::initializer_list<T> ts) {
+    for (auto t : ts)
+      insert(t);
+  }
+
+  // The set of all enumerators
+  static constexpr enum_set all() {
+    enum_set s;
+    for (std::size_t w = 0; w != word_count; ++w)
+      s.m_words[w] = word_mask(w);
+    return s;
+  }
+
+  // Returns true if t wasn't a member already
+  constexpr bool insert(T t) {
+    const auto i = index_of(t);
+    if (i == num_enumerators)
+      return false;
+    const auto old = m_words[i / bits];
+    m_words[i / bits] |= std::uint64_t(1) << (i % bits);
+    return old != m_words[i / bits];
+  }
+
+  // Returns the number of elements removed, 0 or 1
+  constexpr std::size_t erase(T t) {
+    const auto i = index_of(t);
+    if (i == num_enumerators)
+      return 0;
+    const auto old = m_words[i / bits];
+    m_words[i / bits] &= ~(std::uint64_t(1) << (i % bits));
+    return old != m_words[i / bits];
+  }
+
+  constexpr bool contains(T t) const {
+    const auto i = index_of(t);
+    return i != num_enumerators && ((m_words[i / bits] >> (i % bits)) & 1);
+  }
+
+  constexpr std::size_t count(T t) const { return contains(t); }
+
+  constexpr void clear() {
+    for (std::size_t w = 0; w != word_count; ++w)
+      m_words[w] = 0;
+  }
+
+  constexpr std::size_t size() const {
+    std::size_t n = 0;
+    for (std::size_t w = 0; w != word_count; ++w)
+      n += detail::popcount(m_words[w]);
+    return n;
+  }
+
+  constexpr bool empty() const {
+    std::uint64_t any = 0;
+    for (std::size_t w = 0; w != word_count; ++w)
+      any |= m_words[w];
+    return any == 0;
+  }
+
+  static constexpr std::size_t max_size() { return num_enumerators; }
+
+  constexpr iterator begin() const { return {this, next(0)}; }
+  constexpr iterator end() const { return {this, num_enumerators}; }
+
+  constexpr enum_set &operator|=(const enum_set &other) {
+    for (std::size_t w = 0; w != word_count; ++w)
+      m_words[w] |= other.m_words[w];
+    return *this;
+  }
+
+  constexpr enum_set &operator&=(const enum_set &other) {
+    for (std::size_t w = 0; w != word_count; ++w)
+      m_words[w] &= other.m_words[w];
+    return *this;
+  }
+
+  // Set difference
+  constexpr enum_set &operator-=(const enum_set &other) {
+    for (std::size_t w = 0; w != word_count; ++w)
+      m_words[w] &= ~other.m_words[w];
+    return *this;
+  }
+
+  // Symmetric difference
+  constexpr enum_set &operator^=(const enum_set &other) {
+    for (std::size_t w = 0; w != word_count; ++w)
+      m_words[w] ^= other.m_words[w];
+    return *this;
+  }
+
+  // Complement with respect to all enumerators
+  constexpr enum_set operator~() const { return all() - *this; }
+
+  friend constexpr enum_set operator|(enum_set a, const enum_set &b) {
+    return a |= b;
+  }
+  friend constexpr enum_set operator&(enum_set a, const enum_set &b) {
+    return a &= b;
+  }
+  friend constexpr enum_set operator-(enum_set a, const enum_set &b) {
+    return a -= b;
+  }
+  friend constexpr enum_set operator^(enum_set a, const enum_set &b) {
+    return a ^= b;
+  }
+
+  friend constexpr bool operator==(const enum_set &a, const enum_set &b) {
+    std::uint64_t diff = 0;
+    for (std::size_t w = 0; w != word_count; ++w)
+      diff |= a.m_words[w] ^ b.m_words[w];
+    return diff == 0;
+  }
+  friend constexpr bool operator!=(const enum_set &a, const enum_set &b) {
+    return !(a == b);
+  }
+
+  // Raw access to the bits, e.g. for serialization; bit i of word i / 64 is
+  // range<T>[i]. Bits past size<T>, and those of aliases, are always zero.
+  static constexpr std::size_t words() { return word_count; }
+  constexpr std::uint64_t word(std::size_t w) const { return m_words[w]; }
+  constexpr void set_word(std::size_t w, std::uint64_t value) {
+    m_words[w] = value & word_mask(w);
+  }
+
+private:
+  // Index of the first member at position i or later, or size<T>
+  constexpr std::size_t next(std::size_t i) const {
+    if (i >= num_enumerators)
+      return num_enumerators;
+    auto w = i / bits;
+    auto remaining = m_words[w] & (~std::uint64_t(0) << (i % bits));
+    while (remaining == 0) {
+      if (++w == word_count)
+        return num_enumerators;
+      remaining = m_words[w];
+    }
+    return w * bits + detail::countr_zero(remaining);
+  }
+
+  std::uint64_t m_words[word_count] = {};
+};
+
+} // namespace wise_enum
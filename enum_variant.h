@@ -0,0 +1,274 @@
+#pragma once
+
+#include "visit.h"
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wise_enum {
+
+struct bad_enum_variant_access : std::exception {
+  const char *what() const noexcept override {
+    return "Error, enum_variant holds another alternative!";
+  }
+};
+
+namespace detail {
+
+template <class E, template <E> class Mapping, std::size_t... I>
+constexpr bool all_mapped_trivially_copyable(std::index_sequence<I...>) {
+  return all_true<std::is_trivially_copyable<
+      Mapping<value_table<E>::values[I]>>::value...>::value;
+}
+
+template <class E, template <E> class Mapping, std::size_t... I>
+constexpr bool all_mapped_nothrow_movable(std::index_sequence<I...>) {
+  return all_true<std::is_nothrow_move_constructible<
+      Mapping<value_table<E>::values[I]>>::value...>::value;
+}
+
+template <class E, template <E> class Mapping, std::size_t... I>
+constexpr bool all_mapped_nothrow_move_assignable(std::index_sequence<I...>) {
+  return all_true<std::is_nothrow_move_assignable<
+      Mapping<value_table<E>::values[I]>>::value...>::value;
+}
+
+// Selects the storage constructor that creates a value initialized
+// alternative for the first enumerator
+struct first_alternative_t {};
+
+// Storage for trivially copyable alternatives: the implicit copy and
+// destruction are correct, and trivial
+template <class E, template <E> class Mapping>
+struct enum_variant_trivial_storage {
+  using indices = std::make_index_sequence<size<E>>;
+
+  // Leaves the storage empty, for the constructors of derived storage to fill
+  enum_variant_trivial_storage() = default;
+
+  explicit enum_variant_trivial_storage(first_alternative_t) {
+    construct_first();
+  }
+
+  template <E e>
+  Mapping<e> *ptr() noexcept {
+    return reinterpret_cast<Mapping<e> *>(m_buffer);
+  }
+  template <E e>
+  const Mapping<e> *ptr() const noexcept {
+    return reinterpret_cast<const Mapping<e> *>(m_buffer);
+  }
+
+  void destroy() noexcept {}
+
+  // The tag is only set once the alternative exists, so that if its
+  // constructor throws, there is nothing to destroy
+  void construct_first() {
+    constexpr auto first = value_table<E>::values[0];
+    ::new (static_cast<void *>(m_buffer)) Mapping<first>();
+    m_tag = first;
+  }
+
+  alignas(max_mapped_alignment<E, Mapping>(indices{})) unsigned char
+      m_buffer[max_mapped_size<E, Mapping>(indices{})];
+  E m_tag;
+};
+
+// Storage for other alternatives: copies, moves and destruction go through
+// visit on the tag
+template <class E, template <E> class Mapping>
+struct enum_variant_storage : enum_variant_trivial_storage<E, Mapping> {
+  static_assert(all_mapped_nothrow_movable<E, Mapping>(
+                    std::make_index_sequence<size<E>>{}),
+                "Error, enum_variant alternatives must be nothrow move "
+                "constructible");
+
+  // Not default constructible: the tag must always name a live alternative
+  explicit enum_variant_storage(first_alternative_t) {
+    this->construct_first();
+  }
+
+  enum_variant_storage(const enum_variant_storage &other)
+      : enum_variant_trivial_storage<E, Mapping>() {
+    ::wise_enum::visit(other.m_tag, [&](auto c) {
+      constexpr auto e = decltype(c)::value;
+      ::new (static_cast<void *>(this->m_buffer))
+          Mapping<e>(*other.template ptr<e>());
+    });
+    this->m_tag = other.m_tag;
+  }
+  enum_variant_storage(enum_variant_storage &&other) noexcept
+      : enum_variant_trivial_storage<E, Mapping>() {
+    ::wise_enum::visit(other.m_tag, [&](auto c) {
+      constexpr auto e = decltype(c)::value;
+      ::new (static_cast<void *>(this->m_buffer))
+          Mapping<e>(std::move(*other.template ptr<e>()));
+    });
+    this->m_tag = other.m_tag;
+  }
+
+  enum_variant_storage &operator=(const enum_variant_storage &other) {
+    ::wise_enum::visit(other.m_tag, [&](auto c) {
+      constexpr auto e = decltype(c)::value;
+      if (this->m_tag == e) {
+        *this->template ptr<e>() = *other.template ptr<e>();
+      } else {
+        // Copy first, so that a throwing copy leaves this untouched
+        Mapping<e> copy(*other.template ptr<e>());
+        destroy();
+        ::new (static_cast<void *>(this->m_buffer))
+            Mapping<e>(std::move(copy));
+        this->m_tag = e;
+      }
+    });
+    return *this;
+  }
+  enum_variant_storage &operator=(enum_variant_storage &&other) noexcept(
+      all_mapped_nothrow_move_assignable<E, Mapping>(
+          std::make_index_sequence<size<E>>{})) {
+    ::wise_enum::visit(other.m_tag, [&](auto c) {
+      constexpr auto e = decltype(c)::value;
+      if (this->m_tag == e) {
+        *this->template ptr<e>() = std::move(*other.template ptr<e>());
+      } else {
+        destroy();
+        ::new (static_cast<void *>(this->m_buffer))
+            Mapping<e>(std::move(*other.template ptr<e>()));
+        this->m_tag = e;
+      }
+    });
+    return *this;
+  }
+
+  ~enum_variant_storage() { destroy(); }
+
+  void destroy() noexcept {
+    ::wise_enum::visit(this->m_tag,
+                       [this](auto c) {
+                         using A = Mapping<decltype(c)::value>;
+                         this->template ptr<decltype(c)::value>()->~A();
+                       },
+                       [](E) {});
+  }
+};
+
+template <class E, template <E> class Mapping>
+using enum_variant_storage_t = std::conditional_t<
+    all_mapped_trivially_copyable<E, Mapping>(
+        std::make_index_sequence<size<E>>{}),
+    enum_variant_trivial_storage<E, Mapping>, enum_variant_storage<E, Mapping>>;
+
+} // namespace detail
+
+/*
+  A tagged union whose discriminant is a wise enum: Mapping is a class template
+  from enumerators to the type of the alternative they tag, e.g.
+
+    template <MsgType M> struct payload;
+    template <> struct payload<MsgType::PING> { std::uint64_t nonce; };
+    template <> struct payload<MsgType::DATA> { char bytes[60]; };
+
+    using message = wise_enum::enum_variant<MsgType, payload>;
+    auto m = message::make<MsgType::PING>(payload<MsgType::PING>{42});
+    switch (m.tag()) {...}
+
+  Unlike std::variant, the stored tag is the enum itself, so it can be switched
+  on, or passed to anything taking the enum, as is. The layout is a buffer
+  sized and aligned for the largest alternative, followed by the tag, with
+  nothing else. Several enumerators may map to the same type.
+
+  visit(f) calls f(enumerator_constant<E, ...>, alternative&), through
+  wise_enum::visit's jump table. When every alternative is trivially copyable,
+  so is enum_variant (arrays of messages can be memcpy'd, written and read
+  back); otherwise its copies, moves and destructor visit the tag, and
+  alternatives must be nothrow move constructible. Move assignment is noexcept
+  if every alternative is nothrow move assignable.
+
+  A default constructed enum_variant holds a value initialized alternative for
+  the first enumerator.
+ */
+template <class E, template <E> class Mapping>
+class enum_variant : private detail::enum_variant_storage_t<E, Mapping> {
+  static_assert(is_wise_enum_v<E>, "enum_variant is only for wise enum types");
+
+  using storage = detail::enum_variant_storage_t<E, Mapping>;
+
+public:
+  template <E e>
+  using alternative_t = Mapping<e>;
+
+  enum_variant() : storage(detail::first_alternative_t{}) {}
+
+  template <E e, class... Args>
+  static enum_variant make(Args &&... args) {
+    enum_variant v;
+    v.template emplace<e>(std::forward<Args>(args)...);
+    return v;
+  }
+
+  E tag() const noexcept { return this->m_tag; }
+
+  template <E e, class... Args>
+  Mapping<e> &emplace(Args &&... args) {
+    // Constructed first, so that a throwing constructor leaves this untouched.
+    // With no arguments, this is value initialization.
+    auto value = Mapping<e>(std::forward<Args>(args)...);
+    this->destroy();
+    ::new (static_cast<void *>(this->m_buffer)) Mapping<e>(std::move(value));
+    this->m_tag = e;
+    return *this->template ptr<e>();
+  }
+
+  // Replaces the current alternative with a value initialized one for e,
+  // chosen at runtime
+  void emplace(E e) {
+    ::wise_enum::visit(
+        e, [this](auto c) { this->template emplace<decltype(c)::value>(); });
+  }
+
+  template <E e>
+  bool holds() const noexcept {
+    return this->m_tag == e;
+  }
+
+  template <E e>
+  Mapping<e> &get() {
+    if (this->m_tag != e)
+      throw bad_enum_variant_access{};
+    return *this->template ptr<e>();
+  }
+  template <E e>
+  const Mapping<e> &get() const {
+    if (this->m_tag != e)
+      throw bad_enum_variant_access{};
+    return *this->template ptr<e>();
+  }
+
+  template <E e>
+  Mapping<e> *get_if() noexcept {
+    return this->m_tag == e ? this->template ptr<e>() : nullptr;
+  }
+  template <E e>
+  const Mapping<e> *get_if() const noexcept {
+    return this->m_tag == e ? this->template ptr<e>() : nullptr;
+  }
+
+  template <class F>
+  decltype(auto) visit(F &&f) {
+    return ::wise_enum::visit(this->m_tag, [&](auto c) -> decltype(auto) {
+      return std::forward<F>(f)(c, *this->template ptr<decltype(c)::value>());
+    });
+  }
+  template <class F>
+  decltype(auto) visit(F &&f) const {
+    return ::wise_enum::visit(this->m_tag, [&](auto c) -> decltype(auto) {
+      return std::forward<F>(f)(c, *this->template ptr<decltype(c)::value>());
+    });
+  }
+};
+
+} // namespace wise_enum
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstdint>
+
+namespace wise_enum {
+namespace detail {
+
+// 64 bit FNV-1a; trivial to reimplement in any other language, which matters
+// if the peer in a handshake isn't C++
+constexpr std::uint64_t fnv_offset = 0xcbf29ce484222325u;
+constexpr std::uint64_t fnv_prime = 0x100000001b3u;
+
+constexpr std::uint64_t fnv_byte(std::uint64_t h, unsigned char c) {
+  return (h ^ c) * fnv_prime;
+}
+
+constexpr std::uint64_t fnv_uint64(std::uint64_t h, std::uint64_t v) {
+  // little endian, independently of the platform
+  for (int i = 0; i != 8; ++i)
+    h = fnv_byte(h, static_cast<unsigned char>(v >> (8 * i)));
+  return h;
+}
+
+constexpr std::uint64_t fnv_string(std::uint64_t h, const char *s) {
+  for (; *s; ++s)
+    h = fnv_byte(h, static_cast<unsigned char>(*s));
+  return fnv_byte(h, 0);
+}
+
+template <class U, class = typename std::enable_if<
+                       !std::is_same<U, const char *>::value>::type>
+constexpr std::uint64_t fnv_string(std::uint64_t h, U s) {
+  for (std::size_t i = 0; i != s.size(); ++i)
+    h = fnv_byte(h, static_cast<unsigned char>(s[i]));
+  return fnv_byte(h, 0);
+}
+
+template <class T>
+constexpr std::uint64_t make_fingerprint() {
+  auto h = fnv_uint64(fnv_offset, size<T>);
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    h = fnv_string(h, range<T>[i].name);
+    h = fnv_uint64(h, to_uint64(range<T>[i].value));
+  }
+  return h;
+}
+
+} // namespace detail
+
+/*
+  A 64 bit hash of the schema of a wise enum: the number of enumerators, and
+  the name and value of each one, in declared order. Two builds that disagree on
+  any of these will (with overwhelming probability) have different
+  fingerprints, so peers exchanging enums as integers can check compatibility
+  by comparing one integer, and only compare range<T> in detail on mismatch.
+
+  The hash is FNV-1a over, for each enumerator, the bytes of its name followed
+  by a zero byte, and then its value sign extended to 64 bits, in little endian
+  order. The whole thing is prefixed by the count, also as 64 bits little
+  endian. It doesn't depend on the platform, the string type, or the
+  underlying type of the enum.
+ */
+template <class T>
+constexpr std::uint64_t fingerprint = detail::make_fingerprint<T>();
+
+} // namespace wise_enum
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ Flags interface
+
+ Opts a wise enum whose enumerators are bit masks into flags support: type safe
+ bitwise operators (|, &, ^, ~ and the compound assignments), and conversion of
+ combinations to and from strings like "A|B|C". These macros must be used in
+ the same scope as the enum declaration, after it.
+
+ Usage notes:
+   - ~ only flips bits used by some enumerator; when every such bit is also
+     an enumerator, the result of any operator on valid combinations is a
+     valid combination
+   - enumerators spanning several bits (e.g. READ_WRITE = READ | WRITE) are
+     allowed; they can be parsed, and are written out as their single bits
+     when those are enumerators, by their own name otherwise
+*/
+
+// Enable flags for an enum declared at namespace scope
+#define WISE_ENUM_FLAGS(name) WISE_ENUM_IMPL_FLAGS(name, )
+
+// Enable flags for an enum declared at class scope
+#define WISE_ENUM_FLAGS_MEMBER(name) WISE_ENUM_IMPL_FLAGS(name, friend)
+
+namespace wise_enum {
+namespace detail {
+
+std::false_type wise_enum_detail_flags(...);
+
+template <class T>
+struct is_flags : decltype(wise_enum_detail_flags(Tag<T>{})) {};
+
+template <class T>
+constexpr std::uint64_t flag_bits(T t) {
+  return static_cast<std::uint64_t>(
+      static_cast<std::make_unsigned_t<std::underlying_type_t<T>>>(t));
+}
+
+template <class T>
+constexpr std::uint64_t make_flags_mask() {
+  std::uint64_t m = 0;
+  for (std::size_t i = 0; i != size<T>; ++i)
+    m |= flag_bits(range<T>[i].value);
+  return m;
+}
+
+template <class T>
+constexpr constexpr_array<index_type<T>, 64> make_flag_names() {
+  constexpr_array<index_type<T>, 64> a{};
+  for (std::size_t b = 0; b != 64; ++b)
+    a[b] = size<T>;
+  // backwards, so that duplicates resolve to the first enumerator
+  for (std::size_t i = size<T>; i != 0; --i) {
+    const auto v = flag_bits(range<T>[i - 1].value);
+    if (v != 0 && (v & (v - 1)) == 0)
+      a[countr_zero(v)] = static_cast<index_type<T>>(i - 1);
+  }
+  return a;
+}
+
+// Union of the enumerators that are a single bit
+template <class T>
+constexpr std::uint64_t make_single_bits_mask() {
+  std::uint64_t m = 0;
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    const auto v = flag_bits(range<T>[i].value);
+    if ((v & (v - 1)) == 0)
+      m |= v;
+  }
+  return m;
+}
+
+template <class T>
+constexpr std::size_t find_zero() {
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    if (flag_bits(range<T>[i].value) == 0)
+      return i;
+  }
+  return size<T>;
+}
+
+template <class T>
+struct flags_table {
+  // Union of the bits of all enumerators
+  static constexpr std::uint64_t mask = make_flags_mask<T>();
+  // Union of the single bit enumerators
+  static constexpr std::uint64_t single_bits = make_single_bits_mask<T>();
+  // names[b] is the index of the enumerator whose value is exactly bit b, or
+  // size<T> if there isn't one
+  static constexpr constexpr_array<index_type<T>, 64> names =
+      make_flag_names<T>();
+  // Index of the enumerator with value 0, or size<T>
+  static constexpr std::size_t zero = find_zero<T>();
+};
+
+template <class T>
+constexpr constexpr_array<index_type<T>, 64> flags_table<T>::names;
+
+template <class T>
+constexpr T flags_complement(T t) {
+  return static_cast<T>(~flag_bits(t) & flags_table<T>::mask);
+}
+
+// The bits of t that are covered by enumerators made only of bits of t
+template <class T>
+constexpr std::uint64_t covered_bits(std::uint64_t t) {
+  std::uint64_t covered = t & flags_table<T>::single_bits;
+  for (std::size_t i = 0; covered != t && i != size<T>; ++i) {
+    const auto v = flag_bits(range<T>[i].value);
+    if ((v & ~t) == 0)
+      covered |= v;
+  }
+  return covered;
+}
+
+// Index of the enumerator named [p, p + n), or size<T>
+template <class T>
+std::size_t find_name(const char *p, std::size_t n) {
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    const auto name = range<T>[i].name;
+    if (str_size(name) != n)
+      continue;
+    const auto data = str_data(name);
+    std::size_t j = 0;
+    while (j != n && data[j] == p[j])
+      ++j;
+    if (j == n)
+      return i;
+  }
+  return size<T>;
+}
+
+} // namespace detail
+
+// A type trait; true for wise enums with flags enabled
+template <class T>
+using is_flags = detail::is_flags<T>;
+
+template <class T>
+constexpr bool is_flags_v = is_flags<T>::value;
+
+// The combination of all flags
+template <class T>
+constexpr T all_flags = static_cast<T>(detail::flags_table<T>::mask);
+
+// True if t is a combination of enumerators, i.e. each bit set in t belongs to
+// an enumerator whose bits are all set in t. These are exactly the values
+// flags_to_string can write.
+template <class T>
+constexpr bool is_valid_flags(T t) {
+  return detail::covered_bits<T>(detail::flag_bits(t)) ==
+         detail::flag_bits(t);
+}
+
+/*
+  Writes the names of the flags set in t, separated by '|' (e.g. "A|B|C"), into
+  buffer in a single pass over the set bits, without allocating. Single bit
+  flags are written in the order of their bits. Bits that aren't single bit
+  enumerators are then written as the multi bit enumerators covering them, in
+  declared order. If t is 0, writes the name of the enumerator with value 0, if
+  any, and otherwise nothing.
+
+  Like snprintf, the output is truncated to fit in size characters including
+  the null terminator, and the length of the full string is returned, so the
+  output was truncated if and only if the result is >= size. If t isn't a
+  combination of enumerators (see is_valid_flags), nothing is written and 0 is
+  returned; use is_valid_flags to tell this apart from an empty string.
+ */
+template <class T>
+std::size_t flags_to_string(T t, char *buffer, std::size_t size) {
+  static_assert(is_flags_v<T>, "flags_to_string is only for flags enums");
+  using table = detail::flags_table<T>;
+
+  std::size_t length = 0;
+  auto append = [&](string_type name) {
+    const auto data = detail::str_data(name);
+    const auto n = detail::str_size(name);
+    for (std::size_t i = 0; i != n; ++i, ++length) {
+      if (length + 1 < size)
+        buffer[length] = data[i];
+    }
+  };
+  auto finish = [&](std::size_t n) {
+    if (size != 0)
+      buffer[n < size ? n : size - 1] = '\0';
+    return n;
+  };
+
+  auto bits = detail::flag_bits(t);
+  if (bits == 0) {
+    if (table::zero != ::wise_enum::size<T>)
+      append(range<T>[table::zero].name);
+    return finish(length);
+  }
+  auto append_flag = [&](string_type name) {
+    if (length != 0) {
+      if (length + 1 < size)
+        buffer[length] = '|';
+      ++length;
+    }
+    append(name);
+  };
+
+  // Bits without a single bit enumerator
+  const auto rest = bits & ~table::single_bits;
+  if (rest != 0 && detail::covered_bits<T>(bits) != bits)
+    return finish(0);
+  for (bits &= table::single_bits; bits != 0; bits &= bits - 1)
+    append_flag(range<T>[table::names[detail::countr_zero(bits)]].name);
+
+  const auto all = detail::flag_bits(t);
+  auto uncovered = rest;
+  for (std::size_t i = 0; uncovered != 0; ++i) {
+    const auto v = detail::flag_bits(range<T>[i].value);
+    if ((v & ~all) == 0 && (v & uncovered) != 0) {
+      append_flag(range<T>[i].name);
+      uncovered &= ~v;
+    }
+  }
+  return finish(length);
+}
+
+// Parses a combination of flags names separated by '|' (without whitespace),
+// as written by flags_to_string. Each name may be any enumerator, including
+// multi bit ones. The empty string parses as 0. Returns an empty optional if
+// any name doesn't match an enumerator.
+template <class T>
+optional_type<T> flags_from_string(string_type s) {
+  static_assert(is_flags_v<T>, "flags_from_string is only for flags enums");
+  const auto p = detail::str_data(s);
+  const auto n = detail::str_size(s);
+
+  std::uint64_t bits = 0;
+  if (n == 0)
+    return static_cast<T>(bits);
+  std::size_t start = 0;
+  for (std::size_t i = 0; i <= n; ++i) {
+    if (i != n && p[i] != '|')
+      continue;
+    const auto index = detail::find_name<T>(p + start, i - start);
+    if (index == ::wise_enum::size<T>)
+      return {};
+    bits |= detail::flag_bits(range<T>[index].value);
+    start = i + 1;
+  }
+  return static_cast<T>(bits);
+}
+
+} // namespace wise_enum
+
+#define WISE_ENUM_IMPL_FLAGS_OP(name, friendly, op)                            \
+  friendly constexpr name operator op(name a, name b) {                        \
+    return static_cast<name>(                                                  \
+        static_cast<std::underlying_type<name>::type>(a)                       \
+            op static_cast<std::underlying_type<name>::type>(b));              \
+  }                                                                            \
+  friendly WISE_ENUM_CONSTEXPR_14 name &operator op##=(name &a, name b) {      \
+    return a = a op b;                                                         \
+  }
+
+#define WISE_ENUM_IMPL_FLAGS(name, friendly)                                   \
+  friendly std::true_type wise_enum_detail_flags(                              \
+      ::wise_enum::detail::Tag<name>);                                         \
+  WISE_ENUM_IMPL_FLAGS_OP(name, friendly, |)                                   \
+  WISE_ENUM_IMPL_FLAGS_OP(name, friendly, &)                                   \
+  WISE_ENUM_IMPL_FLAGS_OP(name, friendly, ^)                                   \
+  friendly constexpr name operator~(name a) {                                  \
+    return ::wise_enum::detail::flags_complement(a);                           \
+  }
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace wise_enum {
+
+namespace detail {
+
+// Counts data into total, bin key(value) for each value, where keys are in
+// [0, Bins). Keys are computed a block at a time, and counted into several
+// sub-histograms that are summed at the end.
+template <std::size_t Bins, class T, class Key>
+void count_keys(const T *data, std::size_t count, Key key,
+                std::size_t (&total)[Bins]) {
+  constexpr std::size_t lanes = 4;
+  constexpr std::size_t block = 64;
+
+  std::size_t bins[lanes][Bins] = {};
+  std::size_t keys[block];
+
+  std::size_t i = 0;
+  for (; i + block <= count; i += block) {
+    for (std::size_t j = 0; j != block; ++j)
+      keys[j] = key(data[i + j]);
+    for (std::size_t j = 0; j != block; j += lanes) {
+      ++bins[0][keys[j]];
+      ++bins[1][keys[j + 1]];
+      ++bins[2][keys[j + 2]];
+      ++bins[3][keys[j + 3]];
+    }
+  }
+  for (; i != count; ++i)
+    ++bins[0][key(data[i])];
+
+  for (std::size_t j = 0; j != Bins; ++j)
+    total[j] = bins[0][j] + bins[1][j] + bins[2][j] + bins[3][j];
+}
+
+// Dense enums: values are binned by their clamped offset from the smallest
+// one, then bins are mapped to ordinals once at the end, so the key is only a
+// subtraction and a min
+template <class T>
+std::array<std::size_t, size<T>> histogram(const T *data, std::size_t count,
+                                           std::true_type) {
+  using table = index_table<T>;
+  constexpr std::uint64_t min = table::min;
+  constexpr std::uint64_t last = table::span + 1;
+  std::size_t bins[table::dense_size];
+  count_keys(data, count,
+             [](T t) {
+               const auto offset = to_uint64(t) - min;
+               return static_cast<std::size_t>(offset < last ? offset : last);
+             },
+             bins);
+
+  std::array<std::size_t, size<T>> result{};
+  for (std::size_t j = 0; j != last; ++j) {
+    const auto ordinal = table::dense_table[j];
+    if (ordinal != size<T>)
+      result[ordinal] += bins[j];
+  }
+  return result;
+}
+
+// Other enums are binned by index_of, i.e. a binary search per value
+template <class T>
+std::array<std::size_t, size<T>> histogram(const T *data, std::size_t count,
+                                           std::false_type) {
+  std::size_t bins[size<T> + 1];
+  count_keys(data, count, [](T t) { return index_of(t); }, bins);
+
+  std::array<std::size_t, size<T>> result{};
+  for (std::size_t j = 0; j != size<T>; ++j)
+    result[j] = bins[j];
+  return result;
+}
+
+} // namespace detail
+
+/*
+  Counts the occurrences of each enumerator in [data, data + count). The result
+  is in declared order, i.e. result[i] is the number of occurrences of
+  range<T>[i].value, so it can be zipped with range<T> to attach names. Values
+  that are not enumerators are not counted.
+
+  Implementation note: a naive histogram is bound by store to load forwarding;
+  runs of equal values (very common in real data) make each increment wait on
+  the previous one. We spread consecutive elements over several sub-histograms
+  and sum them at the end. Bin numbers are computed a block at a time into a
+  small buffer first, which keeps that work off the increments' dependency
+  chain. For densely valued enums, the bin is the value's offset from the
+  smallest enumerator, clamped to an extra bin for non enumerators: that loop
+  has no branch or table load, and GCC vectorizes it at -O3 (on x86, from
+  SSE4.1 for 32 bit and wider underlying types). The increments themselves are
+  scattered, and stay scalar. For sparse enums (e.g. flags), the bin is
+  index_of, a binary search, and isn't vectorized.
+ */
+template <class T>
+std::array<std::size_t, size<T>> histogram(const T *data, std::size_t count) {
+  return detail::histogram(
+      data, count, std::integral_constant<bool, detail::index_table<T>::dense>{});
+}
+
+namespace detail {
+
+template <class Container>
+using element_t =
+    std::decay_t<decltype(*std::declval<const Container &>().data())>;
+
+} // namespace detail
+
+// Overload for any contiguous container exposing data() and size(), e.g.
+// std::vector, std::array or a span type. The enum may be given explicitly,
+// as in histogram<Color>(v), or deduced from the elements.
+template <class T = void, class Container,
+          class E = std::conditional_t<std::is_void<T>::value,
+                                       detail::element_t<Container>, T>>
+std::array<std::size_t, size<E>> histogram(const Container &c) {
+  static_assert(std::is_same<E, detail::element_t<Container>>::value,
+                "Error, histogram's enum type must be the container's "
+                "element type");
+  return histogram(c.data(), c.size());
+}
+
+} // namespace wise_enum
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wise_enum {
+
+/*
+  A small direct mapped cache in front of from_string, that learns which names
+  are common in the input as it goes, rather than being told ahead of time
+  (see lookup_hint.h for that). Each of the Slots slots, selected by a hash of
+  the input, remembers the last enumerator found through it. A hit costs a hash
+  and a single name comparison; a miss falls back to the same search as
+  from_string, then fills the slot. Inputs that aren't names always miss.
+
+  The cache is a fixed size array of ordinals plus two counters, with no
+  allocation and no locks: it is not thread safe, and is meant to be used from
+  a single thread. cached_from_string uses one per thread and enum type.
+ */
+template <class T, std::size_t Slots = 64>
+class lookup_cache {
+  static_assert(is_wise_enum_v<T>, "lookup_cache is only for wise enum types");
+  static_assert(Slots != 0 && (Slots & (Slots - 1)) == 0,
+                "Error, lookup_cache needs a power of two number of slots");
+
+  // Slots hold an ordinal plus one, so that zero means empty
+  using slot_type = detail::smallest_uint_t<size<T>>;
+
+public:
+  struct stats {
+    std::uint64_t hits;
+    std::uint64_t misses;
+
+    double hit_rate() const noexcept {
+      const auto total = hits + misses;
+      return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+    }
+  };
+
+  constexpr lookup_cache() noexcept : m_slots{}, m_hits(0), m_misses(0) {}
+
+  optional_type<T> from_string(string_type s) {
+    auto &slot =
+        m_slots[detail::name_hash(detail::str_data(s), detail::str_size(s)) &
+                (Slots - 1)];
+    if (slot != 0 && detail::compare(range<T>[slot - 1].name, s)) {
+      ++m_hits;
+      return range<T>[slot - 1].value;
+    }
+    ++m_misses;
+    for (std::size_t i = 0; i != size<T>; ++i) {
+      if (detail::compare(range<T>[i].name, s)) {
+        slot = static_cast<slot_type>(i + 1);
+        return range<T>[i].value;
+      }
+    }
+    return {};
+  }
+
+  stats statistics() const noexcept { return {m_hits, m_misses}; }
+
+  void reset_statistics() noexcept {
+    m_hits = 0;
+    m_misses = 0;
+  }
+
+  // Forgets all names (but not the statistics)
+  void clear() noexcept {
+    for (auto &slot : m_slots)
+      slot = 0;
+  }
+
+private:
+  slot_type m_slots[Slots];
+  std::uint64_t m_hits;
+  std::uint64_t m_misses;
+};
+
+namespace detail {
+
+template <class T>
+lookup_cache<T> &thread_lookup_cache() noexcept {
+  // Constant initialized, so there is no guard on access
+  thread_local lookup_cache<T> cache;
+  return cache;
+}
+
+} // namespace detail
+
+// from_string through the calling thread's lookup_cache for T. The result is
+// always the same as that of from_string.
+template <class T>
+optional_type<T> cached_from_string(string_type s) {
+  return detail::thread_lookup_cache<T>().from_string(s);
+}
+
+// Hits and misses of cached_from_string<T> on the calling thread
+template <class T>
+typename lookup_cache<T>::stats cached_from_string_statistics() noexcept {
+  return detail::thread_lookup_cache<T>().statistics();
+}
+
+} // namespace wise_enum
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace wise_enum {
+
+// A from_string hint: the listed enumerators are tried first, in the order
+// given, then all others in declared order
+template <class T, T... Hot>
+struct hot_first {};
+
+// A from_string hint: enumerators are tried by decreasing weight (e.g. their
+// expected frequency), ties in declared order. There must be one weight per
+// enumerator, in declared order.
+template <class T, std::uint32_t... Weights>
+struct by_weight {};
+
+namespace detail {
+
+template <class T>
+using search_order = constexpr_array<smallest_uint_t<size<T>>, size<T>>;
+
+template <class T, T... Hot>
+constexpr search_order<T> hot_first_order() {
+  search_order<T> order{};
+  bool placed[size<T>] = {};
+  // One extra element, so that the array isn't empty without hints
+  const T hot[] = {Hot..., T{}};
+  std::size_t n = 0;
+  for (std::size_t i = 0; i != sizeof...(Hot); ++i) {
+    const auto j = index_of(hot[i]);
+    // In a constant expression, this makes a bad hint a compilation error
+    if (j == size<T>)
+      throw std::invalid_argument("Error, hot_first hint is not an enumerator");
+    if (!placed[j]) {
+      placed[j] = true;
+      order[n++] = static_cast<smallest_uint_t<size<T>>>(j);
+    }
+  }
+  for (std::size_t j = 0; j != size<T>; ++j) {
+    if (!placed[j])
+      order[n++] = static_cast<smallest_uint_t<size<T>>>(j);
+  }
+  return order;
+}
+
+template <class T, std::uint32_t... Weights>
+constexpr search_order<T> by_weight_order() {
+  const std::uint32_t weights[] = {Weights...};
+  search_order<T> order{};
+  bool placed[size<T>] = {};
+  // Selection sort; each pass picks the heaviest enumerator left, the first
+  // declared among equals
+  for (std::size_t n = 0; n != size<T>; ++n) {
+    std::size_t best = size<T>;
+    for (std::size_t j = 0; j != size<T>; ++j) {
+      if (!placed[j] && (best == size<T> || weights[j] > weights[best]))
+        best = j;
+    }
+    placed[best] = true;
+    order[n] = static_cast<smallest_uint_t<size<T>>>(best);
+  }
+  return order;
+}
+
+template <class Hint>
+struct hint_order;
+
+template <class T, T... Hot>
+struct hint_order<hot_first<T, Hot...>> {
+  static constexpr search_order<T> order = hot_first_order<T, Hot...>();
+};
+
+template <class T, T... Hot>
+constexpr search_order<T> hint_order<hot_first<T, Hot...>>::order;
+
+template <class T, std::uint32_t... Weights>
+struct hint_order<by_weight<T, Weights...>> {
+  static_assert(sizeof...(Weights) == size<T>,
+                "Error, by_weight needs one weight per enumerator");
+  static constexpr search_order<T> order = by_weight_order<T, Weights...>();
+};
+
+template <class T, std::uint32_t... Weights>
+constexpr search_order<T> hint_order<by_weight<T, Weights...>>::order;
+
+template <class T, class Hint>
+constexpr optional_type<T> from_string_in_order(string_type s) {
+  const auto &order = hint_order<Hint>::order;
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    const auto &e = range<T>[order[i]];
+    if (compare(e.name, s))
+      return e.value;
+  }
+  return {};
+}
+
+} // namespace detail
+
+/*
+  from_string, with a compile time hint of which enumerators are the most
+  likely, so that they are compared first. When a few names make up most of
+  the input, they then resolve in one or two comparisons, instead of a scan in
+  declared order:
+
+    using hint = wise_enum::hot_first<Token, Token::GET, Token::PUT>;
+    auto t = wise_enum::from_string(s, hint{});
+
+  The result is always the same as that of from_string; only the order in
+  which names are compared changes.
+ */
+template <class T, T... Hot>
+constexpr optional_type<T> from_string(string_type s, hot_first<T, Hot...>) {
+  return detail::from_string_in_order<T, hot_first<T, Hot...>>(s);
+}
+
+template <class T, std::uint32_t... Weights>
+constexpr optional_type<T> from_string(string_type s,
+                                       by_weight<T, Weights...>) {
+  return detail::from_string_in_order<T, by_weight<T, Weights...>>(s);
+}
+
+} // namespace wise_enum
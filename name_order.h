@@ -0,0 +1,99 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace wise_enum {
+namespace detail {
+
+constexpr bool less(const char *s1, const char *s2) {
+  return strcmp(s1, s2) < 0;
+}
+
+template <class U, class = typename std::enable_if<
+                       !std::is_same<U, const char *>::value>::type>
+constexpr bool less(U u1, U u2) {
+  return u1 < u2;
+}
+
+template <class T>
+struct name_order {
+  // rank[index_of(t)] is the position of t's name in sorted order; non
+  // enumerators rank last
+  index_type<T> rank[size<T> + 1];
+  // by_rank[r] is the index of the enumerator with rank r
+  index_type<T> by_rank[size<T>];
+};
+
+template <class T>
+constexpr name_order<T> make_name_order() {
+  name_order<T> o{};
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    std::size_t r = 0;
+    for (std::size_t j = 0; j != size<T>; ++j) {
+      if (less(range<T>[j].name, range<T>[i].name) ||
+          (j < i && !less(range<T>[i].name, range<T>[j].name)))
+        ++r;
+    }
+    o.rank[i] = static_cast<index_type<T>>(r);
+    o.by_rank[r] = static_cast<index_type<T>>(i);
+  }
+  o.rank[size<T>] = size<T>;
+  return o;
+}
+
+template <class T>
+struct name_order_table {
+  static constexpr name_order<T> value = make_name_order<T>();
+};
+
+template <class T>
+constexpr name_order<T> name_order_table<T>::value;
+
+} // namespace detail
+
+// Returns the rank of the name of t among the names of all enumerators of T,
+// in lexicographic order; if t isn't an enumerator, returns size<T>. Comparing
+// ranks is equivalent to comparing names, but costs only integer compares.
+template <class T>
+constexpr std::size_t name_rank(T t) {
+  return detail::name_order_table<T>::value.rank[index_of(t)];
+}
+
+// Comparator ordering enumerators by name, e.g. for std::sort or std::map
+struct name_less {
+  template <class T>
+  constexpr bool operator()(T t1, T t2) const {
+    return name_rank(t1) < name_rank(t2);
+  }
+};
+
+/*
+  Sorts [first, last) by name, as std::stable_sort with name_less would, but in
+  linear time: counts each enumerator, then writes each one out as many times
+  as it was seen, in name order. If the range contains values that are not
+  enumerators, their order can't be recovered from counts, so it falls back to
+  a comparison sort.
+ */
+template <class T>
+void sort_by_name(T *first, T *last) {
+  constexpr std::size_t n = size<T>;
+  std::size_t counts[n + 1] = {};
+  for (auto it = first; it != last; ++it)
+    ++counts[index_of(*it)];
+
+  if (counts[n] != 0) {
+    std::stable_sort(first, last, name_less{});
+    return;
+  }
+
+  const auto &order = detail::name_order_table<T>::value;
+  for (std::size_t r = 0; r != n; ++r) {
+    const auto i = order.by_rank[r];
+    first = std::fill_n(first, counts[i], range<T>[i].value);
+  }
+}
+
+} // namespace wise_enum
@@ -32,8 +32,10 @@ public:
 
   WISE_ENUM_CONSTEXPR_14 T &operator*() & { return m_t; }
   constexpr const T &operator*() const & { return m_t; }
-  WISE_ENUM_CONSTEXPR_14 T &&operator*() && { return m_t; }
-  constexpr const T &&operator*() const && { return m_t; }
+  WISE_ENUM_CONSTEXPR_14 T &&operator*() && { return static_cast<T &&>(m_t); }
+  constexpr const T &&operator*() const && {
+    return static_cast<const T &&>(m_t);
+  }
 
   constexpr explicit operator bool() const noexcept { return m_active; }
   constexpr bool has_value() const noexcept { return m_active; }
@@ -53,13 +55,13 @@ public:
 
   WISE_ENUM_CONSTEXPR_14 T &&value() && {
     if (m_active)
-      return m_t;
+      return static_cast<T &&>(m_t);
     else
       throw bad_optional_access{};
   }
   constexpr const T &&value() const && {
     if (m_active)
-      return m_t;
+      return static_cast<const T &&>(m_t);
     else
       throw bad_optional_access{};
   }
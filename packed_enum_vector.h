@@ -0,0 +1,362 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace wise_enum {
+namespace detail {
+
+constexpr std::size_t bits_for(std::size_t n) {
+  std::size_t b = 1;
+  while ((std::size_t(1) << b) < n)
+    ++b;
+  return b;
+}
+
+// True if the values of T are consecutive, in declared order, i.e. the
+// ordinal of a value is its distance from the first enumerator
+template <class T>
+constexpr bool is_sequential() {
+  for (std::size_t i = 0; i != size<T>; ++i) {
+    if (to_uint64(range<T>[i].value) - to_uint64(range<T>[0].value) != i)
+      return false;
+  }
+  return true;
+}
+
+template <class T>
+constexpr constexpr_array<std::uint64_t, index_table<T>::dense_size>
+make_wide_ordinals() {
+  constexpr_array<std::uint64_t, index_table<T>::dense_size> a{};
+  for (std::size_t i = 0; i != a.size(); ++i)
+    a[i] = index_table<T>::dense_table[i];
+  return a;
+}
+
+template <class T>
+constexpr constexpr_array<std::uint64_t, size<T>> make_wide_values() {
+  constexpr_array<std::uint64_t, size<T>> a{};
+  for (std::size_t i = 0; i != size<T>; ++i)
+    a[i] = to_uint64(range<T>[i].value);
+  return a;
+}
+
+/*
+  Conversions between values and ordinals for the bulk loops of
+  packed_enum_vector, written so that compilers can vectorize them. For
+  sequential enums (the default numbering), both ways are an addition. For
+  other dense enums, they are loads from tables of 64 bit entries, as vector
+  gathers can't load narrower ones, indexed by the clamped offset of the value
+  one way. Sparse enums go through index_of, a binary search, which isn't
+  vectorized.
+ */
+template <class T>
+struct packed_codec {
+  using table = index_table<T>;
+  static constexpr bool sequential = is_sequential<T>();
+  static constexpr std::uint64_t first = to_uint64(range<T>[0].value);
+
+  static constexpr constexpr_array<std::uint64_t, table::dense_size> ordinals =
+      make_wide_ordinals<T>();
+  static constexpr constexpr_array<std::uint64_t, size<T>> values =
+      make_wide_values<T>();
+
+  static std::uint64_t ordinal(T t) {
+    const auto offset = to_uint64(t) - table::min;
+    if (sequential)
+      return offset;
+    if (table::dense)
+      return ordinals[offset < table::span + 1 ? offset : table::span + 1];
+    return index_of(t);
+  }
+
+  static T value(std::uint64_t ordinal) {
+    using U = std::underlying_type_t<T>;
+    if (sequential)
+      return static_cast<T>(static_cast<U>(first + ordinal));
+    return static_cast<T>(static_cast<U>(values[ordinal]));
+  }
+};
+
+template <class T>
+constexpr constexpr_array<std::uint64_t, index_table<T>::dense_size>
+    packed_codec<T>::ordinals;
+template <class T>
+constexpr constexpr_array<std::uint64_t, size<T>> packed_codec<T>::values;
+
+} // namespace detail
+
+/*
+  A vector of enumerators that stores each one as its ordinal (index_of), in
+  the minimum number of bits, ceil(log2(size<T>)). Elements are packed into 64
+  bit words, and never straddle two words, so random access is a division by a
+  constant, a shift and a mask, followed by a table lookup to get the value
+  back. E.g. an enum with 5 enumerators takes 3 bits per element, 21 elements
+  per word, instead of sizeof(underlying type) bytes.
+
+  pack and unpack convert whole runs of elements at once, a word at a time, in
+  two branch free steps: between values and ordinals (see detail::packed_codec)
+  and between ordinals and their bit fields in the word. With GCC at -O3 both
+  steps are vectorized for dense enums (on x86, from AVX2 for the per element
+  shifts and table gathers).
+
+  Only enumerators can be stored; storing anything else is undefined behavior
+  (and asserts in debug builds).
+ */
+template <class T>
+class packed_enum_vector {
+  static_assert(is_wise_enum_v<T>,
+                "packed_enum_vector is only for wise enum types");
+
+  using word_type = std::uint64_t;
+
+public:
+  // Number of bits used per element
+  static constexpr std::size_t bits_per_element =
+      detail::bits_for(::wise_enum::size<T>);
+  static constexpr std::size_t elements_per_word = 64 / bits_per_element;
+
+  using value_type = T;
+  using size_type = std::size_t;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    const_iterator() = default;
+    const_iterator(const packed_enum_vector *v, std::size_t i)
+        : m_vector(v), m_index(i) {}
+
+    T operator*() const { return (*m_vector)[m_index]; }
+    T operator[](difference_type n) const { return *(*this + n); }
+
+    const_iterator &operator++() {
+      ++m_index;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto copy = *this;
+      ++m_index;
+      return copy;
+    }
+    const_iterator &operator--() {
+      --m_index;
+      return *this;
+    }
+    const_iterator operator--(int) {
+      auto copy = *this;
+      --m_index;
+      return copy;
+    }
+    const_iterator &operator+=(difference_type n) {
+      m_index += n;
+      return *this;
+    }
+    const_iterator &operator-=(difference_type n) {
+      m_index -= n;
+      return *this;
+    }
+    friend const_iterator operator+(const_iterator it, difference_type n) {
+      return it += n;
+    }
+    friend const_iterator operator+(difference_type n, const_iterator it) {
+      return it += n;
+    }
+    friend const_iterator operator-(const_iterator it, difference_type n) {
+      return it -= n;
+    }
+    friend difference_type operator-(const_iterator a, const_iterator b) {
+      return static_cast<difference_type>(a.m_index) -
+             static_cast<difference_type>(b.m_index);
+    }
+
+    friend bool operator==(const_iterator a, const_iterator b) {
+      return a.m_index == b.m_index;
+    }
+    friend bool operator!=(const_iterator a, const_iterator b) {
+      return a.m_index != b.m_index;
+    }
+    friend bool operator<(const_iterator a, const_iterator b) {
+      return a.m_index < b.m_index;
+    }
+    friend bool operator>(const_iterator a, const_iterator b) {
+      return b < a;
+    }
+    friend bool operator<=(const_iterator a, const_iterator b) {
+      return !(b < a);
+    }
+    friend bool operator>=(const_iterator a, const_iterator b) {
+      return !(a < b);
+    }
+
+  private:
+    const packed_enum_vector *m_vector = nullptr;
+    std::size_t m_index = 0;
+  };
+  using iterator = const_iterator;
+
+  packed_enum_vector() = default;
+
+  explicit packed_enum_vector(std::size_t n, T t = range<T>[0].value) {
+    resize(n, t);
+  }
+
+  packed_enum_vector(std::initializer_list<T> ts) {
+    pack(ts.begin(), ts.size());
+  }
+
+  std::size_t size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+  std::size_t capacity() const noexcept {
+    return m_words.capacity() * elements_per_word;
+  }
+
+  // Bytes of storage used by the elements
+  std::size_t size_in_bytes() const noexcept {
+    return m_words.size() * sizeof(word_type);
+  }
+
+  void reserve(std::size_t n) { m_words.reserve(words_for(n)); }
+
+  void clear() noexcept {
+    m_words.clear();
+    m_size = 0;
+  }
+
+  void resize(std::size_t n, T t = range<T>[0].value) {
+    while (m_size < n && m_size % elements_per_word != 0)
+      push_back(t);
+    if (m_size < n) {
+      // Whole words at a time from here
+      const auto code = ordinal(t);
+      word_type word = 0;
+      for (std::size_t j = 0; j != elements_per_word; ++j)
+        word |= code << (j * bits_per_element);
+      m_words.resize(words_for(n), word);
+    } else {
+      m_words.resize(words_for(n));
+    }
+    // Keep the bits past the last element zero
+    if (n % elements_per_word != 0)
+      m_words.back() &=
+          (word_type(1) << (n % elements_per_word * bits_per_element)) - 1;
+    m_size = n;
+  }
+
+  T operator[](std::size_t i) const {
+    const auto shift = i % elements_per_word * bits_per_element;
+    const auto code = (m_words[i / elements_per_word] >> shift) & mask;
+    return detail::value_table<T>::values[code];
+  }
+
+  T front() const { return (*this)[0]; }
+  T back() const { return (*this)[m_size - 1]; }
+
+  void set(std::size_t i, T t) { set_code(i, ordinal(t)); }
+
+  void push_back(T t) {
+    if (m_size % elements_per_word == 0)
+      m_words.push_back(0);
+    const auto shift = m_size % elements_per_word * bits_per_element;
+    m_words.back() |= ordinal(t) << shift;
+    ++m_size;
+  }
+
+  void pop_back() {
+    --m_size;
+    if (m_size % elements_per_word == 0)
+      m_words.pop_back();
+    else
+      set_code(m_size, 0);
+  }
+
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, m_size}; }
+
+  // Appends [in, in + count)
+  void pack(const T *in, std::size_t count) {
+    reserve(m_size + count);
+    // Fill up the last partial word one element at a time
+    for (; count != 0 && m_size % elements_per_word != 0; --count)
+      push_back(*in++);
+    word_type codes[elements_per_word];
+    for (; count >= elements_per_word; count -= elements_per_word) {
+      for (std::size_t j = 0; j != elements_per_word; ++j) {
+        assert(index_of(in[j]) != ::wise_enum::size<T> &&
+               "Error, not an enumerator");
+        codes[j] = detail::packed_codec<T>::ordinal(in[j]);
+      }
+      word_type word = 0;
+      for (std::size_t j = 0; j != elements_per_word; ++j)
+        word |= codes[j] << (j * bits_per_element);
+      m_words.push_back(word);
+      in += elements_per_word;
+      m_size += elements_per_word;
+    }
+    for (; count != 0; --count)
+      push_back(*in++);
+  }
+
+  // Writes the count elements starting at position first to out
+  void unpack(std::size_t first, std::size_t count, T *out) const {
+    for (; count != 0 && first % elements_per_word != 0; --count)
+      *out++ = (*this)[first++];
+    word_type codes[elements_per_word];
+    for (; count >= elements_per_word; count -= elements_per_word) {
+      const auto word = m_words[first / elements_per_word];
+      for (std::size_t j = 0; j != elements_per_word; ++j)
+        codes[j] = (word >> (j * bits_per_element)) & mask;
+      for (std::size_t j = 0; j != elements_per_word; ++j)
+        out[j] = detail::packed_codec<T>::value(codes[j]);
+      out += elements_per_word;
+      first += elements_per_word;
+    }
+    for (; count != 0; --count)
+      *out++ = (*this)[first++];
+  }
+
+  friend bool operator==(const packed_enum_vector &a,
+                         const packed_enum_vector &b) {
+    // unused bits are always zero
+    return a.m_size == b.m_size && a.m_words == b.m_words;
+  }
+  friend bool operator!=(const packed_enum_vector &a,
+                         const packed_enum_vector &b) {
+    return !(a == b);
+  }
+
+private:
+  static constexpr word_type mask = (word_type(1) << bits_per_element) - 1;
+
+  static word_type ordinal(T t) {
+    const auto i = index_of(t);
+    assert(i != ::wise_enum::size<T> && "Error, not an enumerator");
+    return i;
+  }
+
+  static std::size_t words_for(std::size_t n) {
+    return (n + elements_per_word - 1) / elements_per_word;
+  }
+
+  void set_code(std::size_t i, word_type code) {
+    const auto shift = i % elements_per_word * bits_per_element;
+    auto &word = m_words[i / elements_per_word];
+    word = (word & ~(mask << shift)) | (code << shift);
+  }
+
+  std::vector<word_type> m_words;
+  std::size_t m_size = 0;
+};
+
+} // namespace wise_enum
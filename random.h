@@ -0,0 +1,297 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <type_traits>
+
+namespace wise_enum {
+namespace detail {
+
+// True if a single draw from G yields (at least) 32 uniformly random bits
+template <class G>
+constexpr bool draws_32_bits() {
+  return G::min() == 0 && G::max() >= 0xFFFFFFFFu;
+}
+
+/*
+  Maps one 32 bit draw to a uniform index in [0, n) along with a 32 bit
+  remainder, using the multiply-shift technique: the top half of x * n is the
+  index, the bottom half is (close to) uniform in [0, 2^32) and independent of
+  it. No division, no rejection loop; the bias this introduces is at most
+  n / 2^32, negligible for any enum.
+ */
+struct index_and_fraction {
+  std::uint32_t index;
+  std::uint32_t fraction;
+};
+
+template <class G, std::enable_if_t<draws_32_bits<G>(), int> = 0>
+index_and_fraction draw_index(G &g, std::uint32_t n) {
+  const std::uint64_t x = static_cast<std::uint32_t>(g());
+  const std::uint64_t p = x * n;
+  return {static_cast<std::uint32_t>(p >> 32), static_cast<std::uint32_t>(p)};
+}
+
+// Fallback for narrow generators (e.g. minstd_rand), which can't provide 32
+// bits in a single draw
+template <class G, std::enable_if_t<!draws_32_bits<G>(), int> = 0>
+index_and_fraction draw_index(G &g, std::uint32_t n) {
+  std::uniform_int_distribution<std::uint32_t> index(0, n - 1);
+  std::uniform_int_distribution<std::uint32_t> fraction;
+  const auto i = index(g);
+  return {i, fraction(g)};
+}
+
+} // namespace detail
+
+/*
+  Generates each enumerator of T with equal probability. It mirrors the
+  interface of the standard distributions (param_type, min, max, reset,
+  comparison and streaming), so it's used the same way with any standard
+  generator; it isn't a RandomNumberDistribution in the strict sense, which
+  requires an arithmetic result_type. With a generator producing at least 32 bits per call (e.g.
+  mt19937 or mt19937_64), each value costs exactly one draw, a multiplication
+  and a load.
+ */
+template <class T>
+class uniform_enum_distribution {
+  static_assert(is_wise_enum_v<T>,
+                "uniform_enum_distribution is only for wise enum types");
+
+public:
+  using result_type = T;
+
+  struct param_type {
+    using distribution_type = uniform_enum_distribution;
+    friend bool operator==(const param_type &, const param_type &) {
+      return true;
+    }
+    friend bool operator!=(const param_type &, const param_type &) {
+      return false;
+    }
+  };
+
+  uniform_enum_distribution() = default;
+  explicit uniform_enum_distribution(const param_type &) {}
+
+  void reset() {}
+
+  param_type param() const { return {}; }
+  void param(const param_type &) {}
+
+  result_type min() const { return static_cast<T>(detail::min_value<T>()); }
+  result_type max() const { return static_cast<T>(detail::max_value<T>()); }
+
+  template <class G>
+  result_type operator()(G &g) const {
+    return detail::value_table<T>::values[detail::draw_index(g, size<T>).index];
+  }
+
+  template <class G>
+  result_type operator()(G &g, const param_type &) const {
+    return (*this)(g);
+  }
+
+  // Fills [first, last) with independently generated values
+  template <class G>
+  void fill(T *first, T *last, G &g) const {
+    for (; first != last; ++first)
+      *first = (*this)(g);
+  }
+
+  friend bool operator==(const uniform_enum_distribution &,
+                         const uniform_enum_distribution &) {
+    return true;
+  }
+  friend bool operator!=(const uniform_enum_distribution &,
+                         const uniform_enum_distribution &) {
+    return false;
+  }
+
+  template <class CharT, class Traits>
+  friend std::basic_ostream<CharT, Traits> &
+  operator<<(std::basic_ostream<CharT, Traits> &os,
+             const uniform_enum_distribution &) {
+    return os;
+  }
+
+  template <class CharT, class Traits>
+  friend std::basic_istream<CharT, Traits> &
+  operator>>(std::basic_istream<CharT, Traits> &is,
+             uniform_enum_distribution &) {
+    return is;
+  }
+};
+
+namespace detail {
+
+template <std::size_t N>
+constexpr std::uint64_t sum(const std::uint64_t (&weights)[N]) {
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i != N; ++i)
+    total += weights[i];
+  return total;
+}
+
+template <std::size_t N>
+struct alias_table {
+  constexpr_array<std::uint64_t, N> threshold;
+  constexpr_array<std::uint32_t, N> alias;
+};
+
+/*
+  Vose's alias method, in exact integer arithmetic so that it can run at
+  compile time. Column i is kept with probability threshold[i] / 2^32, and
+  otherwise replaced by alias[i].
+ */
+template <std::size_t N>
+constexpr alias_table<N> make_alias_table(const std::uint64_t (&weights)[N]) {
+  alias_table<N> t{};
+  const auto total = sum(weights);
+
+  // Each column is worth total; scaled[i] is how much of it i still needs
+  std::uint64_t scaled[N] = {};
+  std::size_t small[N] = {};
+  std::size_t large[N] = {};
+  std::size_t num_small = 0;
+  std::size_t num_large = 0;
+  for (std::size_t i = 0; i != N; ++i) {
+    scaled[i] = weights[i] * N;
+    t.alias[i] = static_cast<std::uint32_t>(i);
+    if (scaled[i] < total)
+      small[num_small++] = i;
+    else
+      large[num_large++] = i;
+  }
+
+  while (num_small != 0 && num_large != 0) {
+    const auto s = small[--num_small];
+    const auto l = large[--num_large];
+    t.threshold[s] = (scaled[s] << 32) / total;
+    t.alias[s] = static_cast<std::uint32_t>(l);
+    scaled[l] -= total - scaled[s];
+    if (scaled[l] < total)
+      small[num_small++] = l;
+    else
+      large[num_large++] = l;
+  }
+  // Whatever is left fills its own column exactly (up to rounding)
+  while (num_large != 0)
+    t.threshold[large[--num_large]] = std::uint64_t(1) << 32;
+  while (num_small != 0)
+    t.threshold[small[--num_small]] = std::uint64_t(1) << 32;
+  return t;
+}
+
+template <class T, std::uint32_t... Weights>
+struct weighted_table {
+  static constexpr std::uint64_t weights[sizeof...(Weights)] = {Weights...};
+  static constexpr alias_table<sizeof...(Weights)> table =
+      make_alias_table(weights);
+};
+
+template <class T, std::uint32_t... Weights>
+constexpr std::uint64_t
+    weighted_table<T, Weights...>::weights[sizeof...(Weights)];
+template <class T, std::uint32_t... Weights>
+constexpr alias_table<sizeof...(Weights)>
+    weighted_table<T, Weights...>::table;
+
+} // namespace detail
+
+/*
+  Generates enumerators of T with probability proportional to compile time
+  weights, given in declared order: e.g.
+  weighted_enum_distribution<Color, 1, 10> generates the second enumerator ten
+  times as often as the first. The alias table is built at compile time, so
+  each value costs one draw (with a generator of at least 32 bits), a
+  multiplication, two loads and a conditional move.
+ */
+template <class T, std::uint32_t... Weights>
+class weighted_enum_distribution {
+  static_assert(is_wise_enum_v<T>,
+                "weighted_enum_distribution is only for wise enum types");
+  static_assert(sizeof...(Weights) == size<T>,
+                "Error, need exactly one weight per enumerator");
+
+  using table = detail::weighted_table<T, Weights...>;
+
+  static_assert(detail::sum(table::weights) != 0,
+                "Error, at least one weight must be non zero");
+  static_assert(detail::sum(table::weights) * size<T> <= 0xFFFFFFFFu,
+                "Error, total weight times the number of enumerators must fit "
+                "in 32 bits");
+
+public:
+  using result_type = T;
+
+  struct param_type {
+    using distribution_type = weighted_enum_distribution;
+    friend bool operator==(const param_type &, const param_type &) {
+      return true;
+    }
+    friend bool operator!=(const param_type &, const param_type &) {
+      return false;
+    }
+  };
+
+  weighted_enum_distribution() = default;
+  explicit weighted_enum_distribution(const param_type &) {}
+
+  void reset() {}
+
+  param_type param() const { return {}; }
+  void param(const param_type &) {}
+
+  result_type min() const { return static_cast<T>(detail::min_value<T>()); }
+  result_type max() const { return static_cast<T>(detail::max_value<T>()); }
+
+  template <class G>
+  result_type operator()(G &g) const {
+    const auto d = detail::draw_index(g, size<T>);
+    const auto keep = d.fraction < table::table.threshold[d.index];
+    const auto i = keep ? d.index : table::table.alias[d.index];
+    return detail::value_table<T>::values[i];
+  }
+
+  template <class G>
+  result_type operator()(G &g, const param_type &) const {
+    return (*this)(g);
+  }
+
+  // Fills [first, last) with independently generated values
+  template <class G>
+  void fill(T *first, T *last, G &g) const {
+    for (; first != last; ++first)
+      *first = (*this)(g);
+  }
+
+  friend bool operator==(const weighted_enum_distribution &,
+                         const weighted_enum_distribution &) {
+    return true;
+  }
+  friend bool operator!=(const weighted_enum_distribution &,
+                         const weighted_enum_distribution &) {
+    return false;
+  }
+
+  template <class CharT, class Traits>
+  friend std::basic_ostream<CharT, Traits> &
+  operator<<(std::basic_ostream<CharT, Traits> &os,
+             const weighted_enum_distribution &) {
+    return os;
+  }
+
+  template <class CharT, class Traits>
+  friend std::basic_istream<CharT, Traits> &
+  operator>>(std::basic_istream<CharT, Traits> &is,
+             weighted_enum_distribution &) {
+    return is;
+  }
+};
+
+} // namespace wise_enum
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ Registry interface
+
+ WISE_ENUM_REGISTER(type) adds a descriptor of a wise enum to a process wide
+ registry, so that it can be found by name at runtime, e.g. to decode "Color"
+ and "RED" from a configuration file. It must be used at namespace scope, once
+ or more (e.g. in a header) per enum; type is registered under the name as
+ written, so qualify it the way it will be looked up:
+
+   WISE_ENUM_REGISTER(my_lib::Color)
+   ...
+   auto v = wise_enum::decode("my_lib::Color", "RED");
+
+ Registration involves no static initializers: each descriptor, and a pointer
+ to it, are constants, and the pointers are gathered by the linker into a
+ dedicated section. This needs an ELF target and GCC or clang
+ (WISE_ENUM_HAS_REGISTRY is 1); elsewhere, registering compiles, but the
+ registry stays empty.
+*/
+
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#define WISE_ENUM_HAS_REGISTRY 1
+#define WISE_ENUM_IMPL_REGISTRY_SECTION                                        \
+  __attribute__((used, section("wise_enum_registry")))
+#else
+#define WISE_ENUM_HAS_REGISTRY 0
+#define WISE_ENUM_IMPL_REGISTRY_SECTION
+#endif
+
+#define WISE_ENUM_REGISTER(type) WISE_ENUM_IMPL_REGISTER(type, __COUNTER__)
+
+#define WISE_ENUM_IMPL_REGISTER(type, n) WISE_ENUM_IMPL_REGISTER_2(type, n)
+
+#define WISE_ENUM_IMPL_REGISTER_2(type, n)                                     \
+  static constexpr ::wise_enum::enum_descriptor                                \
+      wise_enum_impl_descriptor_##n =                                          \
+          ::wise_enum::detail::make_descriptor<type>(#type);                   \
+  WISE_ENUM_IMPL_REGISTRY_SECTION static const ::wise_enum::enum_descriptor    \
+      *const wise_enum_impl_registered_##n = &wise_enum_impl_descriptor_##n;
+
+namespace wise_enum {
+
+// Everything known about a registered wise enum, without its type. Values are
+// converted to 64 bits, sign extended; cast them back to the enum to use them.
+struct enum_descriptor {
+  string_type type_name;
+  std::size_t size;
+  // size values and names, in declared order
+  const std::uint64_t *values;
+  const string_type *names;
+
+  // Index of the enumerator with this name, or size
+  std::size_t find(string_type name) const {
+    for (std::size_t i = 0; i != size; ++i) {
+      if (detail::compare(names[i], name))
+        return i;
+    }
+    return size;
+  }
+};
+
+namespace detail {
+
+template <class T>
+constexpr constexpr_array<std::uint64_t, size<T>> make_descriptor_values() {
+  constexpr_array<std::uint64_t, size<T>> values{};
+  for (std::size_t i = 0; i != size<T>; ++i)
+    values[i] = to_uint64(range<T>[i].value);
+  return values;
+}
+
+template <class T>
+constexpr constexpr_array<string_type, size<T>> make_descriptor_names() {
+  constexpr_array<string_type, size<T>> names{};
+  for (std::size_t i = 0; i != size<T>; ++i)
+    names[i] = range<T>[i].name;
+  return names;
+}
+
+template <class T>
+struct descriptor_tables {
+  static constexpr constexpr_array<std::uint64_t, size<T>> values =
+      make_descriptor_values<T>();
+  static constexpr constexpr_array<string_type, size<T>> names =
+      make_descriptor_names<T>();
+};
+
+template <class T>
+constexpr constexpr_array<std::uint64_t, size<T>>
+    descriptor_tables<T>::values;
+template <class T>
+constexpr constexpr_array<string_type, size<T>> descriptor_tables<T>::names;
+
+template <class T>
+constexpr enum_descriptor make_descriptor(const char *type_name) {
+  static_assert(is_wise_enum_v<T>,
+                "WISE_ENUM_REGISTER is only for wise enum types");
+  return {type_name, size<T>, descriptor_tables<T>::values.data,
+          descriptor_tables<T>::names.data};
+}
+
+#if WISE_ENUM_HAS_REGISTRY
+// Provided by the linker; weak, so that they are null if nothing is
+// registered
+extern "C" {
+extern const enum_descriptor *const __start_wise_enum_registry[]
+    __attribute__((weak, visibility("hidden")));
+extern const enum_descriptor *const __stop_wise_enum_registry[]
+    __attribute__((weak, visibility("hidden")));
+}
+#endif
+
+inline std::uint32_t name_hash(string_type s) {
+  return name_hash(str_data(s), str_size(s));
+}
+
+/*
+  An open addressing hash table over the registered descriptors, keyed by type
+  name. It's built on first use; the same enum may have been registered from
+  several translation units, in which case only the first descriptor is kept.
+ */
+class registry_index {
+public:
+  registry_index() {
+#if WISE_ENUM_HAS_REGISTRY
+    const auto first = __start_wise_enum_registry;
+    const auto last = __stop_wise_enum_registry;
+    const std::size_t n = first ? static_cast<std::size_t>(last - first) : 0;
+#else
+    const enum_descriptor *const *first = nullptr;
+    const std::size_t n = 0;
+#endif
+    std::size_t capacity = 4;
+    while (capacity < 2 * n)
+      capacity *= 2;
+    m_slots.assign(capacity, nullptr);
+    for (std::size_t i = 0; i != n; ++i) {
+      auto &slot = m_slots[probe(first[i]->type_name)];
+      if (!slot) {
+        slot = first[i];
+        m_all.push_back(first[i]);
+      }
+    }
+  }
+
+  const enum_descriptor *find(string_type type_name) const {
+    return m_slots[probe(type_name)];
+  }
+
+  const std::vector<const enum_descriptor *> &all() const { return m_all; }
+
+private:
+  // The slot holding type_name, or the empty slot where it would go
+  std::size_t probe(string_type type_name) const {
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t i = name_hash(type_name) & mask;; i = (i + 1) & mask) {
+      const auto slot = m_slots[i];
+      if (!slot || compare(slot->type_name, type_name))
+        return i;
+    }
+  }
+
+  std::vector<const enum_descriptor *> m_slots;
+  std::vector<const enum_descriptor *> m_all;
+};
+
+inline const registry_index &registry() {
+  static const registry_index index;
+  return index;
+}
+
+} // namespace detail
+
+// The descriptor registered under this type name, or nullptr
+inline const enum_descriptor *find_enum(string_type type_name) {
+  return detail::registry().find(type_name);
+}
+
+// Every registered enum, each once, in no particular order
+inline const std::vector<const enum_descriptor *> &registered_enums() {
+  return detail::registry().all();
+}
+
+// The value of the enumerator of the given registered enum with the given
+// name, or nullptr if there is no such enum or enumerator
+inline const std::uint64_t *decode(string_type type_name,
+                                   string_type enumerator) {
+  const auto d = find_enum(type_name);
+  if (!d)
+    return nullptr;
+  const auto i = d->find(enumerator);
+  return i == d->size ? nullptr : &d->values[i];
+}
+
+} // namespace wise_enum
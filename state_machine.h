@@ -0,0 +1,120 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace wise_enum {
+
+// A rule of a state_machine: in state from, event moves to state to
+template <class S, class E>
+struct transition {
+  S from;
+  E event;
+  S to;
+};
+
+/*
+  A state machine over a state enum S and an event enum E, compiled from a list
+  of transitions into a dense matrix with one cell per (state, event) pair,
+  indexed by ordinals and holding the ordinal of the next state in the smallest
+  unsigned type that fits. Stepping is two index_of lookups and one table
+  lookup, with no branches for dense enums.
+
+  The rules must be complete: every state needs a transition for every event
+  (transitions to the same state included), and no pair may have two different
+  targets. As with enum_map, in a constant expression a violation is a
+  compilation error, otherwise it throws std::invalid_argument:
+
+    constexpr wise_enum::state_machine<Link, LinkEvent> link{
+        {Link::DOWN, LinkEvent::DIAL, Link::CONNECTING},
+        ...
+    };
+
+  Stepping with a state or event that isn't an enumerator is undefined
+  behavior (and asserts in debug builds).
+ */
+template <class S, class E>
+class state_machine {
+  static_assert(is_wise_enum_v<S>,
+                "state_machine states must be a wise enum type");
+  static_assert(is_wise_enum_v<E>,
+                "state_machine events must be a wise enum type");
+
+  static constexpr std::size_t num_states = size<S>;
+  static constexpr std::size_t num_events = size<E>;
+  static constexpr std::size_t num_cells = num_states * num_events;
+
+  using ordinal_type = detail::smallest_uint_t<num_states>;
+
+public:
+  using state_type = S;
+  using event_type = E;
+
+  constexpr state_machine(std::initializer_list<transition<S, E>> rules)
+      : m_next{} {
+    bool seen[num_cells] = {};
+    for (const auto &r : rules) {
+      const auto from = index_of(r.from);
+      const auto event = index_of(r.event);
+      const auto to = index_of(r.to);
+      if (from == num_states || event == num_events || to == num_states)
+        throw std::invalid_argument(
+            "Error, state_machine transition is not between enumerators");
+      const auto c = from * num_events + event;
+      if (seen[c] && m_next[c] != to)
+        throw std::invalid_argument(
+            "Error, state_machine has conflicting transitions");
+      seen[c] = true;
+      m_next[c] = static_cast<ordinal_type>(to);
+    }
+    for (std::size_t c = 0; c != num_cells; ++c) {
+      // In a constant expression, this makes missing rules a compilation
+      // error
+      if (!seen[c])
+        throw std::invalid_argument(
+            "Error, state_machine is missing a transition");
+    }
+  }
+
+  constexpr S step(S s, E e) const {
+    return detail::value_table<S>::values[m_next[cell(s, e)]];
+  }
+
+  /*
+    Advances n independent machines, one event each: states[i] becomes
+    step(states[i], events[i]). Machines are processed four at a time, with
+    their lookups interleaved, so that the loads overlap rather than wait on
+    each other.
+   */
+  void step_all(S *states, const E *events, std::size_t n) const {
+    const auto &values = detail::value_table<S>::values;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      const auto a = m_next[cell(states[i], events[i])];
+      const auto b = m_next[cell(states[i + 1], events[i + 1])];
+      const auto c = m_next[cell(states[i + 2], events[i + 2])];
+      const auto d = m_next[cell(states[i + 3], events[i + 3])];
+      states[i] = values[a];
+      states[i + 1] = values[b];
+      states[i + 2] = values[c];
+      states[i + 3] = values[d];
+    }
+    for (; i != n; ++i)
+      states[i] = step(states[i], events[i]);
+  }
+
+private:
+  static constexpr std::size_t cell(S s, E e) {
+    assert(index_of(s) != num_states && "Error, not a state");
+    assert(index_of(e) != num_events && "Error, not an event");
+    return index_of(s) * num_events + index_of(e);
+  }
+
+  detail::constexpr_array<ordinal_type, num_cells> m_next;
+};
+
+} // namespace wise_enum
@@ -1,7 +1,37 @@
+#include <atomic_compact_optional.h>
+#include <atomic_enum.h>
+#include <atomic_enum_set.h>
+#include <compact_optional.h>
+#include <dispatch_table.h>
+#include <enum_counter.h>
+#include <enum_map.h>
+#include <enum_object.h>
+#include <enum_set.h>
+#include <enum_variant.h>
+#include <fingerprint.h>
+#include <flags.h>
+#include <histogram.h>
+#include <lookup_cache.h>
+#include <lookup_hint.h>
+#include <name_order.h>
+#include <packed_enum_vector.h>
+#include <random.h>
+#include <registry.h>
+#include <state_machine.h>
+#include <translate.h>
+#include <visit.h>
 #include <wise_enum.h>
 
+#include <algorithm>
 #include <catch2/catch.hpp>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 WISE_ENUM_CLASS((Color, int64_t), (BLACK, 1), BLUE, RED)
 
@@ -13,6 +43,140 @@ enum class MoreColor
 };
 WISE_ENUM_ADAPT(MoreColor, RED, GREEN);
 
+WISE_ENUM_CLASS((Permission, uint32_t), (READ, 1), (WRITE, 2), (EXEC, 4),
+                (ADMIN, 1 << 20))
+WISE_ENUM_FLAGS(Permission)
+
+struct File {
+    WISE_ENUM_MEMBER((Mode, uint8_t), (NONE, 0), (R, 1), (W, 2), (RW, 3), (X, 8))
+    WISE_ENUM_FLAGS_MEMBER(Mode)
+};
+
+WISE_ENUM_CLASS(OrderState, NEW, FILLED, CANCELLED)
+WISE_ENUM_CLASS((OrderStateV2, uint8_t), (CANCELLED, 10), (NEW, 20),
+                (PARTIALLY_FILLED, 30), (FILLED, 40))
+
+// More enumerators than fit in a 64 bit word
+WISE_ENUM_CLASS(Big, B0, B1, B2, B3, B4, B5, B6, B7, B8, B9, B10, B11, B12, B13,
+                B14, B15, B16, B17, B18, B19, B20, B21, B22, B23, B24, B25, B26,
+                B27, B28, B29, B30, B31, B32, B33, B34, B35, B36, B37, B38, B39,
+                B40, B41, B42, B43, B44, B45, B46, B47, B48, B49, B50, B51, B52,
+                B53, B54, B55, B56, B57, B58, B59, B60, B61, B62, B63, B64, B65,
+                B66, B67, B68, B69)
+
+// Unscoped, implicit storage: the sentinel is still the underlying type's max,
+// and only when that's an enumerator is the bitset range searched
+namespace sentinel {
+namespace small {
+WISE_ENUM(Small, A, B, C)
+}
+namespace full {
+WISE_ENUM(Full, A, B, C, D)
+}
+namespace sign {
+WISE_ENUM(Signed, (A, -2), (B, 0), (C, 1))
+}
+namespace top {
+WISE_ENUM((Top, uint8_t), (A, 0), (B, 1), (C, 255))
+}
+WISE_ENUM_CLASS((TopClass, uint8_t), (A, 254), (B, 255))
+}
+
+// No single bit enumerators for bits 1 and 2
+WISE_ENUM_CLASS((Access, unsigned), (R, 1), (WX, 6), (ALL, 7))
+WISE_ENUM_FLAGS(Access)
+
+// Z is an alias of Y
+WISE_ENUM_CLASS(Aliased, X, Y, (Z, 1))
+
+WISE_ENUM_CLASS(Link, DOWN, CONNECTING, UP)
+WISE_ENUM_CLASS(LinkEvent, DIAL, ACK, DROP)
+
+namespace other {
+WISE_ENUM((OrderState, int64_t), NEW, FILLED, CANCELLED)
+}
+namespace reordered {
+WISE_ENUM(OrderState, NEW, CANCELLED, FILLED)
+}
+
+template <OrderStateV2 S>
+struct StateTraits {
+    static constexpr int value = static_cast<int>(S) / 10;
+};
+
+template <OrderState S>
+struct OnOrderState {
+    static int call(int base) { return base + static_cast<int>(S); }
+};
+
+struct Order {
+    virtual ~Order() = default;
+    virtual int describe() const = 0;
+};
+
+template <OrderState S>
+struct OrderIn : Order {
+    explicit OrderIn(int id) : id(id) {}
+    int describe() const override { return id * 10 + static_cast<int>(S); }
+    int id;
+};
+
+template <>
+struct OrderIn<OrderState::FILLED> : Order {
+    explicit OrderIn(int id) : id(id) { ++live; }
+    ~OrderIn() override { --live; }
+    int describe() const override { return -id; }
+    int id;
+    double fills[8] = {};
+    static int live;
+};
+int OrderIn<OrderState::FILLED>::live = 0;
+
+template <OrderState S>
+struct OrderPayload;
+template <>
+struct OrderPayload<OrderState::NEW> {
+    int quantity;
+    double price;
+};
+template <>
+struct OrderPayload<OrderState::FILLED> {
+    int quantity;
+};
+template <>
+struct OrderPayload<OrderState::CANCELLED> {
+    char reason[3];
+};
+
+template <OrderState S>
+using OrderNote = std::string;
+
+// Counts its destructions; its default constructor throws on demand, and its
+// move assignment may throw
+template <OrderState S>
+struct OrderGuard {
+    static bool fail;
+    static int destroyed;
+
+    OrderGuard() {
+        if (fail)
+            throw std::runtime_error("fail");
+    }
+    OrderGuard(const OrderGuard &) = default;
+    OrderGuard(OrderGuard &&) noexcept = default;
+    OrderGuard &operator=(const OrderGuard &) = default;
+    OrderGuard &operator=(OrderGuard &&) { return *this; }
+    ~OrderGuard() { ++destroyed; }
+};
+template <OrderState S>
+bool OrderGuard<S>::fail = false;
+template <OrderState S>
+int OrderGuard<S>::destroyed = 0;
+
+WISE_ENUM_REGISTER(Color)
+WISE_ENUM_REGISTER(Color)
+WISE_ENUM_REGISTER(other::OrderState)
+
 TEST_CASE("invalid mapping", "[wise_enum][cxx14][invalid_enumerator]")
 {
     static_assert(std::is_same<wise_enum::string_type, char const*>::value, "string_type char const* expected for C++14");
@@ -21,3 +185,852 @@ TEST_CASE("invalid mapping", "[wise_enum][cxx14][invalid_enumerator]")
     CHECK(wise_enum::to_string(static_cast<Color>(42)) == nullptr);
     CHECK(wise_enum::to_string(MoreColor::OLIVE) == nullptr);
 }
+
+TEST_CASE("index of enumerator", "[wise_enum][cxx14][index_of]")
+{
+    static_assert(wise_enum::index_of(Color::BLACK) == 0, "");
+    static_assert(wise_enum::index_of(Color::RED) == 2, "");
+    static_assert(wise_enum::index_of(Permission::ADMIN) == 3, "");
+    static_assert(wise_enum::index_of(Permission::EXEC) == 2, "");
+
+    CHECK(wise_enum::index_of(static_cast<Color>(0)) == 3);
+    CHECK(wise_enum::index_of(static_cast<Color>(42)) == 3);
+    CHECK(wise_enum::index_of(static_cast<Permission>(3)) == 4);
+    CHECK(wise_enum::index_of(MoreColor::OLIVE) == 2);
+}
+
+TEST_CASE("histogram", "[wise_enum][cxx14][histogram]")
+{
+    std::vector<Permission> data;
+    for (int i = 0; i != 1000; ++i) {
+        data.push_back(Permission::WRITE);
+        if (i % 10 == 0)
+            data.push_back(Permission::ADMIN);
+        if (i % 100 == 0)
+            data.push_back(static_cast<Permission>(3));
+    }
+
+    auto h = wise_enum::histogram(data);
+    static_assert(h.size() == wise_enum::size<Permission>, "");
+    CHECK(wise_enum::histogram<Permission>(data) == h);
+    CHECK(h[0] == 0);
+    CHECK(h[1] == 1000);
+    CHECK(h[2] == 0);
+    CHECK(h[3] == 100);
+
+    // Dense values, binned by offset; some out of range on both sides
+    std::vector<Color> colors;
+    for (int i = 0; i != 1000; ++i) {
+        colors.push_back(Color::RED);
+        if (i % 4 == 0)
+            colors.push_back(Color::BLACK);
+        if (i % 10 == 0)
+            colors.push_back(static_cast<Color>(i % 3 == 0 ? -5 : 4));
+    }
+    auto hc = wise_enum::histogram(colors);
+    CHECK(hc[0] == 250);
+    CHECK(hc[1] == 0);
+    CHECK(hc[2] == 1000);
+}
+
+TEST_CASE("random enumerators", "[wise_enum][cxx14][random]")
+{
+    std::mt19937 gen(42);
+    std::vector<Permission> data(40000);
+
+    wise_enum::uniform_enum_distribution<Permission> uniform;
+    uniform.fill(data.data(), data.data() + data.size(), gen);
+    for (auto c : wise_enum::histogram(data)) {
+        CHECK(c > 9000);
+        CHECK(c < 11000);
+    }
+    CHECK(uniform.min() == Permission::READ);
+    CHECK(uniform.max() == Permission::ADMIN);
+
+    wise_enum::weighted_enum_distribution<Permission, 1, 0, 2, 5> weighted;
+    weighted.fill(data.data(), data.data() + data.size(), gen);
+    auto h = wise_enum::histogram(data);
+    CHECK(h[0] > 4000);
+    CHECK(h[0] < 6000);
+    CHECK(h[1] == 0);
+    CHECK(h[2] > 9000);
+    CHECK(h[2] < 11000);
+    CHECK(h[3] > 24000);
+    CHECK(h[3] < 26000);
+
+    std::minstd_rand narrow(7);
+    CHECK(wise_enum::index_of(weighted(narrow)) != 1);
+}
+
+TEST_CASE("translate by name", "[wise_enum][cxx14][translate]")
+{
+    static_assert(wise_enum::is_translatable_v<OrderStateV2, OrderState>, "");
+    static_assert(!wise_enum::is_translatable_v<OrderState, OrderStateV2>, "");
+    static_assert(wise_enum::translate<OrderStateV2>(OrderState::FILLED) ==
+                      OrderStateV2::FILLED, "");
+
+    CHECK(wise_enum::translate<OrderStateV2>(OrderState::NEW) == OrderStateV2::NEW);
+    CHECK(wise_enum::translate<OrderState>(OrderStateV2::CANCELLED,
+                                           OrderState::NEW) == OrderState::CANCELLED);
+    CHECK(wise_enum::translate<OrderState>(OrderStateV2::PARTIALLY_FILLED,
+                                           OrderState::NEW) == OrderState::NEW);
+    CHECK(wise_enum::translate<OrderState>(static_cast<OrderStateV2>(0),
+                                           OrderState::NEW) == OrderState::NEW);
+
+    CHECK(wise_enum::try_translate<OrderState>(OrderStateV2::FILLED).value() ==
+          OrderState::FILLED);
+    CHECK(!wise_enum::try_translate<OrderState>(OrderStateV2::PARTIALLY_FILLED));
+}
+
+TEST_CASE("schema fingerprint", "[wise_enum][cxx14][fingerprint]")
+{
+    // Same schema, different namespace, kind of enum and underlying type
+    static_assert(wise_enum::fingerprint<OrderState> ==
+                      wise_enum::fingerprint<other::OrderState>, "");
+    static_assert(wise_enum::fingerprint<OrderState> !=
+                      wise_enum::fingerprint<reordered::OrderState>, "");
+    static_assert(wise_enum::fingerprint<OrderState> !=
+                      wise_enum::fingerprint<OrderStateV2>, "");
+
+    // Stable across platforms and versions
+    CHECK(wise_enum::fingerprint<OrderState> == 0x50ed056178eaa96au);
+}
+
+TEST_CASE("sort by name", "[wise_enum][cxx14][name_order]")
+{
+    // CANCELLED < FILLED < NEW < PARTIALLY_FILLED
+    static_assert(wise_enum::name_rank(OrderStateV2::CANCELLED) == 0, "");
+    static_assert(wise_enum::name_rank(OrderStateV2::NEW) == 2, "");
+    static_assert(wise_enum::name_rank(OrderStateV2::PARTIALLY_FILLED) == 3, "");
+    static_assert(wise_enum::name_less{}(OrderStateV2::FILLED, OrderStateV2::NEW), "");
+
+    std::vector<OrderStateV2> v{OrderStateV2::PARTIALLY_FILLED, OrderStateV2::NEW,
+                                OrderStateV2::FILLED, OrderStateV2::NEW,
+                                OrderStateV2::CANCELLED};
+    auto expected = v;
+    std::stable_sort(expected.begin(), expected.end(), wise_enum::name_less{});
+    CHECK(expected.front() == OrderStateV2::CANCELLED);
+
+    wise_enum::sort_by_name(v.data(), v.data() + v.size());
+    CHECK(v == expected);
+
+    v.push_back(static_cast<OrderStateV2>(0));
+    v.push_back(OrderStateV2::CANCELLED);
+    wise_enum::sort_by_name(v.data(), v.data() + v.size());
+    CHECK(v.front() == OrderStateV2::CANCELLED);
+    CHECK(v.back() == static_cast<OrderStateV2>(0));
+    CHECK(std::is_sorted(v.begin(), v.end(), wise_enum::name_less{}));
+}
+
+TEST_CASE("enum set", "[wise_enum][cxx14][enum_set]")
+{
+    constexpr wise_enum::enum_set<Permission> rw{Permission::READ, Permission::WRITE};
+    static_assert(rw.size() == 2, "");
+    static_assert(rw.contains(Permission::WRITE), "");
+    static_assert(!rw.contains(Permission::ADMIN), "");
+    static_assert((~rw).size() == 2, "");
+    static_assert(sizeof(wise_enum::enum_set<Permission>) == 8, "");
+
+    wise_enum::enum_set<Permission> s;
+    CHECK(s.empty());
+    CHECK(s.insert(Permission::ADMIN));
+    CHECK(!s.insert(Permission::ADMIN));
+    CHECK(!s.insert(static_cast<Permission>(3)));
+    s.insert(Permission::READ);
+    CHECK((s & rw) == wise_enum::enum_set<Permission>{Permission::READ});
+    CHECK((s | rw).size() == 3);
+    CHECK((s - rw) == wise_enum::enum_set<Permission>{Permission::ADMIN});
+    CHECK((s ^ rw).size() == 2);
+    CHECK(s.erase(Permission::ADMIN) == 1);
+    CHECK(s.erase(Permission::ADMIN) == 0);
+
+    wise_enum::enum_set<Big> big{Big::B69, Big::B3, Big::B64, Big::B63};
+    static_assert(sizeof(big) == 16, "");
+    CHECK(big.size() == 4);
+    std::vector<Big> members(big.begin(), big.end());
+    CHECK(members == (std::vector<Big>{Big::B3, Big::B63, Big::B64, Big::B69}));
+    CHECK((~big).size() == 66);
+    CHECK(wise_enum::enum_set<Big>::all().size() == 70);
+    CHECK((big & ~big).empty());
+
+    using aliased = wise_enum::enum_set<Aliased>;
+    static_assert(aliased{Aliased::X, Aliased::Y, Aliased::Z} == aliased::all(),
+                  "");
+    static_assert(aliased::all().size() == 2, "");
+    static_assert((~aliased{Aliased::X, Aliased::Z}).size() == 0, "");
+    const auto all = aliased::all();
+    CHECK(std::vector<Aliased>(all.begin(), all.end()) ==
+          (std::vector<Aliased>{Aliased::X, Aliased::Y}));
+}
+
+constexpr wise_enum::enum_map<Permission, int> bumped(
+    wise_enum::enum_map<Permission, int> m)
+{
+    m[Permission::READ] += 1;
+    for (auto p : m)
+        p.second *= 2;
+    return m;
+}
+
+TEST_CASE("enum map", "[wise_enum][cxx14][enum_map]")
+{
+    constexpr wise_enum::enum_map<Permission, int> bits{
+        {Permission::READ, 4}, {Permission::WRITE, 2},
+        {Permission::EXEC, 1}, {Permission::ADMIN, 0}};
+    static_assert(bits[Permission::WRITE] == 2, "");
+    static_assert(sizeof(bits) == 4 * sizeof(int), "");
+    static_assert(bumped(bits)[Permission::READ] == 10, "");
+    static_assert(bumped(bits) != bits, "");
+    // enum_map<Aliased, int> doesn't compile
+    static_assert(!wise_enum::detail::has_no_aliases<Aliased>(), "");
+
+    constexpr wise_enum::partial_enum_map<Big, int> constant_partial{
+        {Big::B65, 1}, {Big::B2, 2}};
+    static_assert(constant_partial.size() == 2, "");
+    static_assert(constant_partial.at(Big::B65) == 1, "");
+
+    wise_enum::enum_map<Permission, int> m(7);
+    m[Permission::EXEC] = 3;
+    CHECK(m.at(Permission::READ) == 7);
+    CHECK_THROWS_AS(m.at(static_cast<Permission>(3)), std::out_of_range);
+
+    std::vector<Permission> keys;
+    int total = 0;
+    for (auto p : m) {
+        keys.push_back(p.first);
+        total += p.second;
+        p.second = 0;
+    }
+    CHECK(total == 24);
+    CHECK(keys == (std::vector<Permission>{Permission::READ, Permission::WRITE,
+                                           Permission::EXEC, Permission::ADMIN}));
+    CHECK(m == wise_enum::enum_map<Permission, int>{});
+
+    CHECK_THROWS_AS((wise_enum::enum_map<Permission, int>{{Permission::READ, 1}}),
+                    std::invalid_argument);
+
+    wise_enum::partial_enum_map<Big, int> partial{{Big::B65, 1}, {Big::B2, 2}};
+    CHECK(partial.size() == 2);
+    CHECK(partial.find(Big::B3) == nullptr);
+    CHECK(*partial.find(Big::B65) == 1);
+    partial[Big::B3] += 5;
+    CHECK(partial.insert_or_assign(Big::B2, 4) == false);
+    std::vector<std::pair<Big, int>> entries;
+    for (auto p : partial)
+        entries.emplace_back(p.first, p.second);
+    CHECK(entries == (std::vector<std::pair<Big, int>>{
+                         {Big::B2, 4}, {Big::B3, 5}, {Big::B65, 1}}));
+    CHECK(partial.erase(Big::B3) == 1);
+    CHECK(!partial.contains(Big::B3));
+    CHECK_THROWS_AS(partial.at(Big::B3), std::out_of_range);
+}
+
+TEST_CASE("flags", "[wise_enum][cxx14][flags]")
+{
+    static_assert(wise_enum::is_flags_v<Permission>, "");
+    static_assert(!wise_enum::is_flags_v<Color>, "");
+    static_assert(std::is_same<decltype(Permission::READ | Permission::EXEC),
+                               Permission>::value, "");
+    static_assert(std::is_same<decltype(File::R | File::W), File::Mode>::value, "");
+    static_assert((File::R | File::W) == File::RW, "");
+    static_assert(~File::R == (File::W | File::X), "");
+    static_assert(wise_enum::all_flags<File::Mode> == (File::RW | File::X), "");
+    static_assert(wise_enum::is_valid_flags(File::X | File::R), "");
+    static_assert(!wise_enum::is_valid_flags(static_cast<File::Mode>(4)), "");
+    static_assert(wise_enum::is_valid_flags(Access::WX), "");
+    static_assert(!wise_enum::is_valid_flags(static_cast<Access>(3)), "");
+
+    auto p = Permission::READ;
+    p |= Permission::ADMIN;
+    p ^= Permission::READ;
+    CHECK(p == Permission::ADMIN);
+
+    char buffer[32];
+    CHECK(wise_enum::flags_to_string(Permission::ADMIN | Permission::READ |
+                                         Permission::EXEC,
+                                     buffer, sizeof(buffer)) == 15);
+    CHECK(std::string(buffer) == "READ|EXEC|ADMIN");
+    CHECK(wise_enum::flags_to_string(File::RW, buffer, sizeof(buffer)) == 3);
+    CHECK(std::string(buffer) == "R|W");
+    // Multi bit enumerators cover the bits no single bit one does
+    CHECK(wise_enum::flags_to_string(Access::WX, buffer, sizeof(buffer)) == 2);
+    CHECK(std::string(buffer) == "WX");
+    CHECK(wise_enum::flags_to_string(Access::ALL, buffer, sizeof(buffer)) == 4);
+    CHECK(std::string(buffer) == "R|WX");
+    CHECK(wise_enum::flags_from_string<Access>(buffer).value() == Access::ALL);
+    CHECK(wise_enum::flags_to_string(static_cast<Access>(3), buffer,
+                                     sizeof(buffer)) == 0);
+    CHECK(wise_enum::flags_to_string(File::NONE, buffer, sizeof(buffer)) == 4);
+    CHECK(std::string(buffer) == "NONE");
+    CHECK(wise_enum::flags_to_string(static_cast<Permission>(0), buffer,
+                                     sizeof(buffer)) == 0);
+    CHECK(std::string(buffer) == "");
+    CHECK(wise_enum::flags_to_string(static_cast<File::Mode>(5), buffer,
+                                     sizeof(buffer)) == 0);
+    CHECK(wise_enum::flags_to_string(File::RW | File::X, buffer, 4) == 5);
+    CHECK(std::string(buffer) == "R|W");
+
+    CHECK(wise_enum::flags_from_string<Permission>("READ|EXEC").value() ==
+          (Permission::READ | Permission::EXEC));
+    CHECK(wise_enum::flags_from_string<File::Mode>("RW|X").value() ==
+          (File::RW | File::X));
+    CHECK(wise_enum::flags_from_string<File::Mode>("").value() == File::NONE);
+    CHECK(!wise_enum::flags_from_string<File::Mode>("R|"));
+    CHECK(!wise_enum::flags_from_string<File::Mode>("R|Y"));
+}
+
+TEST_CASE("atomic enum set", "[wise_enum][cxx14][atomic_enum_set]")
+{
+    wise_enum::atomic_enum_set<Big> s;
+    std::atomic<int> claimed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 4; ++t) {
+        threads.emplace_back([&] {
+            for (auto e : wise_enum::range<Big>) {
+                if (s.insert(e.value))
+                    ++claimed;
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    CHECK(claimed == 70);
+    CHECK(s.snapshot() == wise_enum::enum_set<Big>::all());
+
+    CHECK(s.erase(Big::B64));
+    CHECK(!s.erase(Big::B64));
+    CHECK(!s.contains(Big::B64));
+    CHECK(!s.any_of({Big::B64}));
+    CHECK(s.any_of({Big::B64, Big::B0}));
+
+    auto removed = s.erase(wise_enum::enum_set<Big>{Big::B1, Big::B64, Big::B69});
+    CHECK(removed == (wise_enum::enum_set<Big>{Big::B1, Big::B69}));
+    auto added = s.insert(wise_enum::enum_set<Big>{Big::B1, Big::B2});
+    CHECK(added == wise_enum::enum_set<Big>{Big::B1});
+    CHECK(s.snapshot().size() == 68);
+    s.clear();
+    CHECK(s.snapshot().empty());
+}
+
+TEST_CASE("atomic enum", "[wise_enum][cxx14][atomic_enum]")
+{
+    wise_enum::atomic_enum<OrderStateV2> state;
+    CHECK(state.load() == OrderStateV2::CANCELLED);
+    state = OrderStateV2::NEW;
+
+    const wise_enum::enum_set<OrderStateV2> open{OrderStateV2::NEW,
+                                                 OrderStateV2::PARTIALLY_FILLED};
+    OrderStateV2 previous;
+    CHECK(state.transition(open, OrderStateV2::PARTIALLY_FILLED, previous));
+    CHECK(previous == OrderStateV2::NEW);
+    CHECK(state.transition(open, OrderStateV2::FILLED));
+    CHECK(!state.transition(open, OrderStateV2::CANCELLED, previous));
+    CHECK(previous == OrderStateV2::FILLED);
+    CHECK(state == OrderStateV2::FILLED);
+
+    auto expected = OrderStateV2::NEW;
+    CHECK(!state.compare_exchange_strong(expected, OrderStateV2::CANCELLED));
+    CHECK(expected == OrderStateV2::FILLED);
+    CHECK(state.exchange(OrderStateV2::NEW) == OrderStateV2::FILLED);
+
+    // Only one of several racing threads gets to cancel
+    std::atomic<int> winners{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 4; ++t) {
+        threads.emplace_back([&] {
+            if (state.transition(open, OrderStateV2::CANCELLED))
+                ++winners;
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    CHECK(winners == 1);
+    CHECK(state.load() == OrderStateV2::CANCELLED);
+}
+
+TEST_CASE("enum counter", "[wise_enum][cxx14][enum_counter]")
+{
+    static wise_enum::enum_counter<OrderStateV2, 4> counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 6; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i != 1000; ++i) {
+                counter.increment(OrderStateV2::NEW);
+                if (i % 2 == 0)
+                    counter.add(OrderStateV2::FILLED, 3);
+                counter.increment(static_cast<OrderStateV2>(0));
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    auto counts = counter.snapshot();
+    CHECK(counts[OrderStateV2::CANCELLED] == 0);
+    CHECK(counts[OrderStateV2::NEW] == 6000);
+    CHECK(counts[OrderStateV2::PARTIALLY_FILLED] == 0);
+    CHECK(counts[OrderStateV2::FILLED] == 9000);
+    CHECK(counter.get(OrderStateV2::NEW) == 6000);
+    CHECK(counter.get(static_cast<OrderStateV2>(0)) == 0);
+
+    counter.reset();
+    CHECK(counter.get(OrderStateV2::NEW) == 0);
+}
+
+TEST_CASE("packed enum vector", "[wise_enum][cxx14][packed_enum_vector]")
+{
+    using vector = wise_enum::packed_enum_vector<OrderStateV2>;
+    static_assert(vector::bits_per_element == 2, "");
+    static_assert(vector::elements_per_word == 32, "");
+    static_assert(wise_enum::packed_enum_vector<Big>::bits_per_element == 7, "");
+    static_assert(wise_enum::packed_enum_vector<Big>::elements_per_word == 9, "");
+
+    std::vector<OrderStateV2> plain;
+    for (int i = 0; i != 1000; ++i)
+        plain.push_back(wise_enum::range<OrderStateV2>[i * 7 % 4].value);
+
+    vector v;
+    v.push_back(OrderStateV2::FILLED);
+    v.pack(plain.data(), plain.size());
+    CHECK(v.size() == 1001);
+    CHECK(v.size_in_bytes() == 32 * 8);
+    CHECK(v.front() == OrderStateV2::FILLED);
+    for (std::size_t i = 0; i != plain.size(); ++i)
+        REQUIRE(v[i + 1] == plain[i]);
+
+    std::vector<OrderStateV2> out(plain.size());
+    v.unpack(1, out.size(), out.data());
+    CHECK(out == plain);
+    CHECK(std::vector<OrderStateV2>(v.begin() + 1, v.end()) == plain);
+
+    v.set(500, OrderStateV2::CANCELLED);
+    CHECK(v[500] == OrderStateV2::CANCELLED);
+    CHECK(v[499] == plain[498]);
+    v.pop_back();
+    CHECK(v.back() == plain[998]);
+
+    vector w(70, OrderStateV2::NEW);
+    w.resize(33);
+    w.resize(40, OrderStateV2::FILLED);
+    CHECK(w[32] == OrderStateV2::NEW);
+    CHECK(w[33] == OrderStateV2::FILLED);
+    w.resize(33);
+    CHECK(w == vector(33, OrderStateV2::NEW));
+    CHECK(std::count(w.begin(), w.end(), OrderStateV2::NEW) == 33);
+    static_assert(!std::is_convertible<std::size_t, vector>::value, "");
+
+    // Sequential values, and dense but not sequential ones, are converted in
+    // bulk differently
+    auto round_trip = [](auto t) {
+        using E = decltype(t);
+        std::vector<E> in;
+        for (std::size_t i = 0; i != 1000; ++i)
+            in.push_back(wise_enum::range<E>[i * 13 % wise_enum::size<E>].value);
+        wise_enum::packed_enum_vector<E> packed;
+        packed.pack(in.data(), in.size());
+        std::vector<E> out(in.size());
+        packed.unpack(0, out.size(), out.data());
+        return out == in;
+    };
+    CHECK(round_trip(Big{}));
+    CHECK(round_trip(File::Mode{}));
+}
+
+TEST_CASE("compact ordinal optional", "[wise_enum][cxx14][compact_optional]")
+{
+    static_assert(sizeof(wise_enum::compact_ordinal_optional<Color>) == 1, "");
+    static_assert(sizeof(wise_enum::compact_ordinal_optional<Big>) == 1, "");
+
+    constexpr wise_enum::compact_ordinal_optional<Permission> admin =
+        Permission::ADMIN;
+    static_assert(admin.has_value(), "");
+    static_assert(*admin == Permission::ADMIN, "");
+
+    wise_enum::compact_ordinal_optional<Color> o;
+    CHECK(!o);
+    CHECK(o.value_or(Color::RED) == Color::RED);
+    CHECK_THROWS_AS(o.value(), wise_enum::bad_optional_access);
+    o = Color::BLUE;
+    CHECK(o.value() == Color::BLUE);
+    o.reset();
+    CHECK(!o.has_value());
+    o = static_cast<Color>(42);
+    CHECK(!o);
+}
+
+TEST_CASE("compact optional sentinel", "[wise_enum][cxx14][compact_optional]")
+{
+    using wise_enum::detail::find_sentinel;
+
+    static_assert(find_sentinel<Color>().value ==
+                      std::numeric_limits<int64_t>::max(), "");
+    static_assert(find_sentinel<sentinel::small::Small>().value ==
+                      std::numeric_limits<std::underlying_type_t<
+                          sentinel::small::Small>>::max(), "");
+    static_assert(find_sentinel<sentinel::sign::Signed>().value ==
+                      std::numeric_limits<std::underlying_type_t<
+                          sentinel::sign::Signed>>::max(), "");
+    static_assert(find_sentinel<File::Mode>().value == 255, "");
+    // max is taken: the largest free value the enum can hold
+    static_assert(find_sentinel<sentinel::top::Top>().value == 254, "");
+    static_assert(find_sentinel<sentinel::TopClass>().value == 253, "");
+
+    wise_enum::compact_optional<sentinel::small::Small> o;
+    CHECK(!o);
+    o = sentinel::small::C;
+    CHECK(o.value() == sentinel::small::C);
+
+    // An explicit sentinel is still usable
+    wise_enum::compact_optional<sentinel::full::Full, 4> f;
+    CHECK(!f);
+    f = sentinel::full::D;
+    CHECK(*f == sentinel::full::D);
+}
+
+TEST_CASE("atomic compact optional", "[wise_enum][cxx14][compact_optional]")
+{
+    using optional = wise_enum::compact_optional<OrderStateV2>;
+    wise_enum::atomic_compact_optional<OrderStateV2> latest;
+    static_assert(sizeof(latest) == sizeof(OrderStateV2), "");
+    CHECK(latest.is_lock_free());
+    CHECK(!latest.load());
+
+    latest = OrderStateV2::NEW;
+    CHECK(latest.load().value() == OrderStateV2::NEW);
+    CHECK(*latest.exchange(OrderStateV2::FILLED) == OrderStateV2::NEW);
+
+    optional expected;
+    CHECK(!latest.compare_exchange_strong(expected, OrderStateV2::CANCELLED));
+    CHECK(*expected == OrderStateV2::FILLED);
+    CHECK(latest.compare_exchange_strong(expected, optional{}));
+    CHECK(!latest.load().has_value());
+
+    // Several publishers, the first one wins
+    std::atomic<int> winners{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 4; ++t) {
+        threads.emplace_back([&] {
+            optional none;
+            if (latest.compare_exchange_strong(none, OrderStateV2::NEW))
+                ++winners;
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    CHECK(winners == 1);
+    CHECK(latest.load().value() == OrderStateV2::NEW);
+    latest.reset();
+    CHECK(!latest.load());
+}
+
+// Tells which value category it was called as
+struct RefQualifiedVisitor {
+    template <class... Cs>
+    int operator()(Cs...) & { return 1; }
+    template <class... Cs>
+    int operator()(Cs...) && { return 2; }
+};
+
+TEST_CASE("visit", "[wise_enum][cxx14][visit]")
+{
+    const auto lift = [](auto c) { return StateTraits<c.value>::value; };
+    CHECK(wise_enum::visit(OrderStateV2::CANCELLED, lift) == 1);
+    CHECK(wise_enum::visit(OrderStateV2::FILLED, lift) == 4);
+    CHECK_THROWS_AS(wise_enum::visit(static_cast<OrderStateV2>(11), lift),
+                    std::out_of_range);
+    CHECK(wise_enum::visit(static_cast<OrderStateV2>(11), lift,
+                           [](OrderStateV2) { return -1; }) == -1);
+
+    // The constant converts to the enum, and works on sparse and big enums
+    for (auto e : wise_enum::range<Permission>)
+        CHECK(wise_enum::visit(e.value, [](Permission p) { return p; }) == e.value);
+    CHECK(wise_enum::visit(Big::B69, [](auto c) {
+              return wise_enum::index_of(decltype(c)::value);
+          }) == 69);
+
+    // Results may be references, and the visitor may be stateful
+    int counts[3] = {};
+    int &r = wise_enum::visit(OrderState::FILLED, [&](auto c) -> int & {
+        return counts[wise_enum::index_of(c.value)];
+    });
+    ++r;
+    CHECK(counts[1] == 1);
+
+    // The visitor is called as the value category it was passed as
+    RefQualifiedVisitor v;
+    CHECK(wise_enum::visit(OrderState::FILLED, v) == 1);
+    CHECK(wise_enum::visit(OrderState::FILLED, RefQualifiedVisitor{}) == 2);
+    CHECK(wise_enum::visit(OrderState::FILLED, v, v) == 1);
+    CHECK(wise_enum::visit(v, OrderState::FILLED, Color::RED) == 1);
+    CHECK(wise_enum::visit(RefQualifiedVisitor{}, OrderState::FILLED,
+                           Color::RED) == 2);
+}
+
+TEST_CASE("multi enum visit", "[wise_enum][cxx14][visit]")
+{
+    const auto flat = [](auto a, auto b, auto c) {
+        return std::integral_constant<std::size_t,
+                                      (wise_enum::index_of(a.value) * 4 +
+                                       wise_enum::index_of(b.value)) * 3 +
+                                          wise_enum::index_of(c.value)>::value;
+    };
+    for (auto a : wise_enum::range<OrderState>)
+        for (auto b : wise_enum::range<OrderStateV2>)
+            for (auto c : wise_enum::range<Color>)
+                CHECK(wise_enum::visit(flat, a.value, b.value, c.value) ==
+                      (wise_enum::index_of(a.value) * 4 +
+                       wise_enum::index_of(b.value)) * 3 +
+                          wise_enum::index_of(c.value));
+
+    CHECK(wise_enum::visit([](auto c) { return c.value; }, Color::RED) ==
+          Color::RED);
+    CHECK_THROWS_AS(wise_enum::visit(flat, OrderState::NEW,
+                                     static_cast<OrderStateV2>(0), Color::RED),
+                    std::out_of_range);
+}
+
+TEST_CASE("dispatch table", "[wise_enum][cxx14][dispatch_table]")
+{
+    using table = wise_enum::dispatch_table<OrderState, int(int)>;
+    constexpr auto handlers = table::make<OnOrderState>();
+    static_assert(handlers.get(OrderState::FILLED) ==
+                      &OnOrderState<OrderState::FILLED>::call, "");
+
+    CHECK(handlers(OrderState::NEW, 10) == 10);
+    CHECK(handlers(OrderState::CANCELLED, 10) == 12);
+    CHECK_THROWS_AS(handlers(static_cast<OrderState>(7), 10),
+                    std::out_of_range);
+
+    auto plugged = handlers;
+    const auto previous =
+        plugged.set(OrderState::FILLED, [](int base) { return -base; });
+    CHECK(previous == &OnOrderState<OrderState::FILLED>::call);
+    CHECK(plugged(OrderState::FILLED, 10) == -10);
+    CHECK(handlers(OrderState::FILLED, 10) == 11);
+    plugged.set_fallback([](int) { return 0; });
+    CHECK(plugged(static_cast<OrderState>(7), 10) == 0);
+    CHECK_THROWS_AS(plugged.set(static_cast<OrderState>(7), nullptr),
+                    std::out_of_range);
+}
+
+TEST_CASE("state machine", "[wise_enum][cxx14][state_machine]")
+{
+    constexpr wise_enum::state_machine<Link, LinkEvent> link{
+        {Link::DOWN, LinkEvent::DIAL, Link::CONNECTING},
+        {Link::DOWN, LinkEvent::ACK, Link::DOWN},
+        {Link::DOWN, LinkEvent::DROP, Link::DOWN},
+        {Link::CONNECTING, LinkEvent::DIAL, Link::CONNECTING},
+        {Link::CONNECTING, LinkEvent::ACK, Link::UP},
+        {Link::CONNECTING, LinkEvent::DROP, Link::DOWN},
+        {Link::UP, LinkEvent::DIAL, Link::UP},
+        {Link::UP, LinkEvent::ACK, Link::UP},
+        {Link::UP, LinkEvent::DROP, Link::DOWN}};
+    static_assert(link.step(Link::CONNECTING, LinkEvent::ACK) == Link::UP, "");
+    static_assert(sizeof(link) == 9, "");
+
+    using machine = wise_enum::state_machine<Link, LinkEvent>;
+    CHECK_THROWS_AS(machine({{Link::DOWN, LinkEvent::ACK, Link::DOWN}}),
+                    std::invalid_argument);
+
+    std::mt19937 gen(7);
+    wise_enum::uniform_enum_distribution<LinkEvent> dist;
+    std::vector<Link> states(1001, Link::DOWN);
+    std::vector<Link> expected = states;
+    for (int round = 0; round != 5; ++round) {
+        std::vector<LinkEvent> events(states.size());
+        for (auto &e : events)
+            e = dist(gen);
+        link.step_all(states.data(), events.data(), states.size());
+        for (std::size_t i = 0; i != expected.size(); ++i)
+            expected[i] = link.step(expected[i], events[i]);
+        CHECK(states == expected);
+    }
+}
+
+TEST_CASE("enum object", "[wise_enum][cxx14][enum_object]")
+{
+    using object = wise_enum::enum_object<OrderState, Order, OrderIn>;
+    static_assert(object::buffer_size ==
+                      sizeof(OrderIn<OrderState::FILLED>), "");
+    static_assert(object::buffer_alignment == alignof(double), "");
+
+    object o(OrderState::CANCELLED, 4);
+    CHECK(o.kind() == OrderState::CANCELLED);
+    CHECK(o->describe() == 42);
+
+    o.emplace(OrderState::FILLED, 3);
+    CHECK(OrderIn<OrderState::FILLED>::live == 1);
+    CHECK(o.kind() == OrderState::FILLED);
+    CHECK((*o).describe() == -3);
+    o.emplace(OrderState::NEW, 1);
+    CHECK(OrderIn<OrderState::FILLED>::live == 0);
+    CHECK(o->describe() == 10);
+
+    CHECK_THROWS_AS(o.emplace(static_cast<OrderState>(9), 1), std::out_of_range);
+    CHECK(!o);
+    object empty;
+    CHECK(!empty.has_value());
+}
+
+TEST_CASE("enum variant", "[wise_enum][cxx14][enum_variant]")
+{
+    using message = wise_enum::enum_variant<OrderState, OrderPayload>;
+    static_assert(std::is_trivially_copyable<message>::value, "");
+    static_assert(sizeof(message) ==
+                      sizeof(OrderPayload<OrderState::NEW>) + sizeof(double),
+                  "");
+
+    message m;
+    CHECK(m.tag() == OrderState::NEW);
+    CHECK(m.get<OrderState::NEW>().quantity == 0);
+
+    std::vector<message> sent{message::make<OrderState::FILLED>(
+                                  OrderPayload<OrderState::FILLED>{7}),
+                              message::make<OrderState::CANCELLED>()};
+    std::vector<message> received(2);
+    std::memcpy(received.data(), sent.data(), sizeof(message) * 2);
+    CHECK(received[0].holds<OrderState::FILLED>());
+    CHECK(received[0].get<OrderState::FILLED>().quantity == 7);
+    CHECK(received[1].get_if<OrderState::NEW>() == nullptr);
+    CHECK_THROWS_AS(received[1].get<OrderState::FILLED>(),
+                    wise_enum::bad_enum_variant_access);
+
+    const auto quantity = [](auto tag, const auto &payload) {
+        return wise_enum::index_of(tag.value) == 2 ? -1
+                                                   : int(sizeof(payload));
+    };
+    CHECK(received[0].visit(quantity) == sizeof(int));
+    CHECK(received[1].visit(quantity) == -1);
+
+    received[1].emplace(OrderState::NEW);
+    CHECK(received[1].get<OrderState::NEW>().price == 0.0);
+
+    using note = wise_enum::enum_variant<OrderState, OrderNote>;
+    static_assert(!std::is_trivially_copyable<note>::value, "");
+    auto n = note::make<OrderState::CANCELLED>(100, 'x');
+    note copy = n;
+    CHECK(copy.tag() == OrderState::CANCELLED);
+    CHECK(copy.get<OrderState::CANCELLED>() == std::string(100, 'x'));
+    copy.emplace<OrderState::FILLED>("done");
+    n = std::move(copy);
+    CHECK(n.get<OrderState::FILLED>() == "done");
+    n = note{};
+    CHECK(n.tag() == OrderState::NEW);
+    CHECK(n.get<OrderState::NEW>().empty());
+    static_assert(std::is_nothrow_move_assignable<note>::value, "");
+
+    // Nothing is destroyed if the first alternative fails to construct
+    using guarded = wise_enum::enum_variant<OrderState, OrderGuard>;
+    static_assert(!std::is_nothrow_move_assignable<guarded>::value, "");
+    OrderGuard<OrderState::NEW>::fail = true;
+    CHECK_THROWS_AS(static_cast<void>(guarded{}), std::runtime_error);
+    CHECK(OrderGuard<OrderState::NEW>::destroyed == 0);
+    OrderGuard<OrderState::NEW>::fail = false;
+    static_cast<void>(guarded{});
+    CHECK(OrderGuard<OrderState::NEW>::destroyed == 1);
+}
+
+TEST_CASE("for each enumerator", "[wise_enum][cxx14][for_each]")
+{
+    std::vector<std::string> names;
+    int traits[4] = {};
+    wise_enum::for_each<OrderStateV2>([&](auto c, wise_enum::string_type name) {
+        names.emplace_back(name);
+        traits[wise_enum::index_of(c.value)] = StateTraits<c.value>::value;
+    });
+    CHECK(names == std::vector<std::string>{"CANCELLED", "NEW",
+                                            "PARTIALLY_FILLED", "FILLED"});
+    CHECK(traits[0] == 1);
+    CHECK(traits[3] == 4);
+
+    // Every call gets its own constant type
+    std::size_t distinct = 0;
+    wise_enum::for_each<Big>([&](auto c, wise_enum::string_type) {
+        static_assert(std::is_same<decltype(c),
+                                   wise_enum::enumerator_constant<
+                                       Big, wise_enum::index_of(c.value)>>::value,
+                      "");
+        ++distinct;
+    });
+    CHECK(distinct == 70);
+}
+
+TEST_CASE("from string with hints", "[wise_enum][cxx14][from_string]")
+{
+    using hot = wise_enum::hot_first<Big, Big::B69, Big::B42, Big::B69>;
+    using order = wise_enum::detail::hint_order<hot>;
+    static_assert(order::order[0] == 69 && order::order[1] == 42, "");
+    static_assert(order::order[2] == 0 && order::order[69] == 68, "");
+
+    for (auto e : wise_enum::range<Big>)
+        CHECK(wise_enum::from_string(e.name, hot{}).value() == e.value);
+    CHECK(!wise_enum::from_string("B70", hot{}));
+    CHECK(wise_enum::from_string("B69", wise_enum::hot_first<Big>{}).value() ==
+          Big::B69);
+
+    using weights = wise_enum::by_weight<OrderStateV2, 1, 50, 1, 90>;
+    using weight_order = wise_enum::detail::hint_order<weights>;
+    static_assert(weight_order::order[0] == 3 && weight_order::order[1] == 1 &&
+                      weight_order::order[2] == 0 &&
+                      weight_order::order[3] == 2,
+                  "");
+    CHECK(wise_enum::from_string("PARTIALLY_FILLED", weights{}).value() ==
+          OrderStateV2::PARTIALLY_FILLED);
+    CHECK(!wise_enum::from_string("FILL", weights{}));
+}
+
+TEST_CASE("from string with a lookup cache", "[wise_enum][cxx14][from_string]")
+{
+    wise_enum::lookup_cache<Big, 16> cache;
+    for (int round = 0; round != 3; ++round) {
+        for (auto e : wise_enum::range<Big>)
+            CHECK(cache.from_string(e.name).value() == e.value);
+    }
+    CHECK(!cache.from_string("B70"));
+    auto stats = cache.statistics();
+    CHECK(stats.hits + stats.misses == 3 * 70 + 1);
+
+    // A skewed input mostly hits
+    cache.reset_statistics();
+    for (int i = 0; i != 1000; ++i)
+        CHECK(cache.from_string(i % 10 == 0 ? "B7" : "B68").has_value());
+    stats = cache.statistics();
+    CHECK(stats.hit_rate() > 0.95);
+
+    cache.clear();
+    CHECK(cache.from_string("B68").value() == Big::B68);
+    CHECK(cache.statistics().misses == stats.misses + 1);
+
+    // One cache per thread
+    CHECK(wise_enum::cached_from_string<OrderState>("FILLED").value() ==
+          OrderState::FILLED);
+    CHECK(wise_enum::cached_from_string<OrderState>("FILLED").value() ==
+          OrderState::FILLED);
+    std::thread([] {
+        CHECK(wise_enum::cached_from_string<OrderState>("FILLED").value() ==
+              OrderState::FILLED);
+        CHECK(wise_enum::cached_from_string_statistics<OrderState>().misses == 1);
+    }).join();
+    CHECK(wise_enum::cached_from_string_statistics<OrderState>().hits == 1);
+}
+
+TEST_CASE("registry", "[wise_enum][cxx14][registry]")
+{
+    if (!WISE_ENUM_HAS_REGISTRY)
+        return;
+
+    CHECK(wise_enum::registered_enums().size() == 2);
+    const auto color = wise_enum::find_enum("Color");
+    REQUIRE(color);
+    CHECK(color->size == 3);
+    CHECK(std::string(color->names[2]) == "RED");
+    CHECK(color->find("BLUE") == 1);
+    CHECK(wise_enum::find_enum("Colour") == nullptr);
+
+    const auto v = wise_enum::decode("other::OrderState", "CANCELLED");
+    REQUIRE(v);
+    CHECK(static_cast<other::OrderState>(*v) == other::CANCELLED);
+    CHECK(wise_enum::decode("Color", "GREEN") == nullptr);
+    CHECK(static_cast<Color>(*wise_enum::decode("Color", "BLACK")) ==
+          Color::BLACK);
+}
@@ -1,6 +1,8 @@
+#include <compact_optional.h>
 #include <wise_enum.h>
 
 #include <catch2/catch.hpp>
+#include <limits>
 #include <string_view>
 #include <type_traits>
 
@@ -14,6 +16,8 @@ enum class MoreColor
 };
 WISE_ENUM_ADAPT(MoreColor, RED, GREEN);
 
+WISE_ENUM((Mode, uint8_t), (NONE, 0), (R, 1), (W, 2), (RW, 3), (X, 8))
+
 TEST_CASE("invalid mapping", "[wise_enum][cxx17][invalid_enumerator]")
 {
     static_assert(std::is_same_v<wise_enum::string_type, std::string_view>);
@@ -37,3 +41,11 @@ TEST_CASE("invalid mapping", "[wise_enum][cxx17][invalid_enumerator]")
     CHECK(greenish.data() == nullptr);
     CHECK(greenish == "");
 }
+
+TEST_CASE("compact optional sentinel", "[wise_enum][cxx17][compact_optional]")
+{
+    // Same as in 14, so that compact_optional<Mode> is the same type in both
+    static_assert(wise_enum::detail::find_sentinel<Mode>().value == 255);
+    static_assert(wise_enum::detail::find_sentinel<Color>().value ==
+                  std::numeric_limits<int64_t>::max());
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cassert>
+#include <cstddef>
+
+namespace wise_enum {
+namespace detail {
+
+template <class To>
+constexpr std::size_t index_of_name(string_type name) {
+  for (std::size_t i = 0; i != size<To>; ++i) {
+    if (compare(range<To>[i].name, name))
+      return i;
+  }
+  return size<To>;
+}
+
+template <class To, class From>
+struct translation {
+  // Indexed by index_of(From); the last entry is for non enumerators
+  To to[size<From> + 1];
+  bool matched[size<From> + 1];
+  bool complete;
+};
+
+template <class To, class From>
+constexpr translation<To, From> make_translation() {
+  translation<To, From> t{};
+  t.complete = true;
+  for (std::size_t i = 0; i != size<From>; ++i) {
+    const auto j = index_of_name<To>(range<From>[i].name);
+    t.matched[i] = j != size<To>;
+    t.to[i] = t.matched[i] ? range<To>[j].value : To{};
+    t.complete = t.complete && t.matched[i];
+  }
+  return t;
+}
+
+template <class To, class From>
+struct translation_table {
+  static constexpr translation<To, From> value = make_translation<To, From>();
+};
+
+template <class To, class From>
+constexpr translation<To, From> translation_table<To, From>::value;
+
+} // namespace detail
+
+// True if every enumerator of From has an enumerator of the same name in To
+template <class To, class From>
+constexpr bool is_translatable_v =
+    detail::translation_table<To, From>::value.complete;
+
+/*
+  Converts between two wise enums by enumerator name: the result is the
+  enumerator of To with the same name as f. The matching is done at compile
+  time, so at runtime this is an ordinal lookup followed by a single load.
+
+  There are three ways to handle names of From missing from To:
+   - translate<To>(f) refuses to compile unless every name is matched. f must
+  be an enumerator (asserted in debug builds); otherwise, the result is To{}
+   - translate<To>(f, fallback) returns fallback for unmatched names (and for
+  values of f that aren't enumerators)
+   - try_translate<To>(f) returns an empty optional_type<To> in the same cases
+ */
+template <class To, class From>
+constexpr To translate(From f) {
+  static_assert(is_wise_enum_v<To> && is_wise_enum_v<From>,
+                "translate is only for wise enum types");
+  static_assert(is_translatable_v<To, From>,
+                "Error, some enumerators of the source enum have no "
+                "enumerator of the same name in the target enum; use the "
+                "fallback or optional versions");
+  const auto i = index_of(f);
+  assert(i != size<From> &&
+         "Error, not an enumerator; use the fallback or optional versions");
+  return detail::translation_table<To, From>::value.to[i];
+}
+
+template <class To, class From>
+constexpr To translate(From f, To fallback) {
+  static_assert(is_wise_enum_v<To> && is_wise_enum_v<From>,
+                "translate is only for wise enum types");
+  const auto i = index_of(f);
+  const auto &t = detail::translation_table<To, From>::value;
+  return t.matched[i] ? t.to[i] : fallback;
+}
+
+template <class To, class From>
+WISE_ENUM_CONSTEXPR_14 optional_type<To> try_translate(From f) {
+  static_assert(is_wise_enum_v<To> && is_wise_enum_v<From>,
+                "try_translate is only for wise enum types");
+  const auto i = index_of(f);
+  const auto &t = detail::translation_table<To, From>::value;
+  if (!t.matched[i])
+    return {};
+  return t.to[i];
+}
+
+} // namespace wise_enum
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 
@@ -13,7 +15,6 @@ template <class T>
 using optional_type = std::optional<T>;
 }
 #else
-
 #include <stdexcept>
 #include <type_traits>
 
@@ -46,8 +47,10 @@ public:
 
   WISE_ENUM_CONSTEXPR_14 T &operator*() & { return m_t; }
   constexpr const T &operator*() const & { return m_t; }
-  WISE_ENUM_CONSTEXPR_14 T &&operator*() && { return m_t; }
-  constexpr const T &&operator*() const && { return m_t; }
+  WISE_ENUM_CONSTEXPR_14 T &&operator*() && { return static_cast<T &&>(m_t); }
+  constexpr const T &&operator*() const && {
+    return static_cast<const T &&>(m_t);
+  }
 
   constexpr explicit operator bool() const noexcept { return m_active; }
   constexpr bool has_value() const noexcept { return m_active; }
@@ -67,13 +70,13 @@ public:
 
   WISE_ENUM_CONSTEXPR_14 T &&value() && {
     if (m_active)
-      return m_t;
+      return static_cast<T &&>(m_t);
     else
       throw bad_optional_access{};
   }
   constexpr const T &&value() const && {
     if (m_active)
-      return m_t;
+      return static_cast<const T &&>(m_t);
     else
       throw bad_optional_access{};
   }
@@ -176,6 +179,92 @@ template <class U, class = typename std::enable_if<
 WISE_ENUM_CONSTEXPR_14 bool compare(U u1, U u2) {
   return u1 == u2;
 }
+
+// Characters and length of a string_type, whichever it is
+inline const char *str_data(const char *s) { return s; }
+inline std::size_t str_size(const char *s) {
+  std::size_t n = 0;
+  while (s[n])
+    ++n;
+  return n;
+}
+
+template <class U, class = typename std::enable_if<
+                       !std::is_same<U, const char *>::value>::type>
+const char *str_data(const U &s) {
+  return s.data();
+}
+template <class U, class = typename std::enable_if<
+                       !std::is_same<U, const char *>::value>::type>
+std::size_t str_size(const U &s) {
+  return s.size();
+}
+
+// FNV-1a; names are short, so hashing costs about as much as finding the
+// length of a C string
+inline std::uint32_t name_hash(const char *p, std::size_t n) {
+  std::uint32_t h = 2166136261u;
+  for (std::size_t i = 0; i != n; ++i) {
+    h ^= static_cast<unsigned char>(p[i]);
+    h *= 16777619u;
+  }
+  return h;
+}
+
+#if __cplusplus >= 201402
+// Smallest unsigned integral type able to hold every value in [0, N]
+template <std::uint64_t N>
+using smallest_uint_t = std::conditional_t<
+    N <= 0xFF, std::uint8_t,
+    std::conditional_t<N <= 0xFFFF, std::uint16_t,
+                       std::conditional_t<N <= 0xFFFFFFFF, std::uint32_t,
+                                          std::uint64_t>>>;
+
+// std::array's mutating members are not constexpr until 17, which makes it
+// useless for building lookup tables at compile time in 14. This is the bare
+// minimum needed for that.
+template <class V, std::size_t N>
+struct constexpr_array {
+  V data[N];
+
+  constexpr V &operator[](std::size_t i) { return data[i]; }
+  constexpr const V &operator[](std::size_t i) const { return data[i]; }
+  static constexpr std::size_t size() { return N; }
+};
+
+// Reinterprets the value of an enumerator as a 64 bit unsigned integer. Values
+// are sign extended first, so differences between two converted values of the
+// same enum are always the correct (wrapping) unsigned distance
+template <class T>
+constexpr std::uint64_t to_uint64(T t) {
+  return static_cast<std::uint64_t>(
+      static_cast<typename std::underlying_type<T>::type>(t));
+}
+
+// Bit manipulation helpers, as found in <bit> in 20
+constexpr int popcount(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555u);
+  x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+  return static_cast<int>((x * 0x0101010101010101u) >> 56);
+#endif
+}
+
+// x must not be 0
+constexpr int countr_zero(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+  for (; !(x & 1); x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+#endif
 } // namespace detail
 } // namespace wise_enum
 
@@ -1210,9 +1299,209 @@ WISE_ENUM_CONSTEXPR_14 optional_type<T> from_string(string_type s) {
 
   return it->value;
 }
-} // namespace wise_enum
 
+#if __cplusplus >= 201402
+namespace detail {
+
+template <class T>
+constexpr std::underlying_type_t<T> min_value() {
+  const auto &r = enumerators<T>::range;
+  auto m = static_cast<std::underlying_type_t<T>>(r[0].value);
+  for (std::size_t i = 1; i != r.size(); ++i) {
+    if (static_cast<std::underlying_type_t<T>>(r[i].value) < m)
+      m = static_cast<std::underlying_type_t<T>>(r[i].value);
+  }
+  return m;
+}
+
+template <class T>
+constexpr std::underlying_type_t<T> max_value() {
+  const auto &r = enumerators<T>::range;
+  auto m = static_cast<std::underlying_type_t<T>>(r[0].value);
+  for (std::size_t i = 1; i != r.size(); ++i) {
+    if (static_cast<std::underlying_type_t<T>>(r[i].value) > m)
+      m = static_cast<std::underlying_type_t<T>>(r[i].value);
+  }
+  return m;
+}
+
+// Number of distinct integral values between the smallest and the largest
+// enumerator, minus one
+template <class T>
+constexpr std::uint64_t value_span() {
+  return to_uint64(static_cast<T>(max_value<T>())) -
+         to_uint64(static_cast<T>(min_value<T>()));
+}
+
+template <class T>
+constexpr bool is_dense() {
+  return value_span<T>() < 4 * enumerators<T>::size;
+}
+
+template <class T>
+using index_type = smallest_uint_t<enumerators<T>::size>;
+
+template <class T>
+struct sorted_entry {
+  std::underlying_type_t<T> value;
+  index_type<T> index;
+};
+
+template <class T, std::size_t N>
+constexpr constexpr_array<index_type<T>, N> make_dense_index() {
+  constexpr_array<index_type<T>, N> a{};
+  for (std::size_t i = 0; i != N; ++i)
+    a[i] = enumerators<T>::size;
+  if (is_dense<T>()) {
+    // iterate backwards, so that duplicate values map to the first one
+    for (std::size_t i = enumerators<T>::size; i != 0; --i) {
+      a[to_uint64(enumerators<T>::range[i - 1].value) -
+        to_uint64(static_cast<T>(min_value<T>()))] =
+          static_cast<index_type<T>>(i - 1);
+    }
+  }
+  return a;
+}
+
+template <class T, std::size_t N>
+constexpr constexpr_array<sorted_entry<T>, N> make_sparse_index() {
+  constexpr_array<sorted_entry<T>, N> a{};
+  if (!is_dense<T>()) {
+    // insertion sort; stable, so duplicate values map to the first one
+    for (std::size_t i = 0; i != N; ++i) {
+      sorted_entry<T> e{
+          static_cast<std::underlying_type_t<T>>(enumerators<T>::range[i].value),
+          static_cast<index_type<T>>(i)};
+      std::size_t j = i;
+      for (; j != 0 && e.value < a[j - 1].value; --j)
+        a[j] = a[j - 1];
+      a[j] = e;
+    }
+  }
+  return a;
+}
 
+/*
+  Compile time tables mapping an enumerator to its position in the declared
+  order. If the values of the enum are reasonably tightly packed, the value
+  (minus the smallest value) directly indexes a table, which makes the lookup a
+  subtraction, a min and a load: out of range offsets are clamped to an extra
+  last entry holding count, so there is no branch, and loops over it can be
+  vectorized. Otherwise (e.g. bit flags) we fall
+  back to a binary search over the values sorted at compile time, so memory use
+  stays proportional to the number of enumerators.
+ */
+template <class T>
+struct index_table {
+  static constexpr std::size_t count = enumerators<T>::size;
+  static constexpr bool dense = is_dense<T>();
+  static constexpr std::uint64_t span = value_span<T>();
+  static constexpr std::uint64_t min = to_uint64(static_cast<T>(min_value<T>()));
+
+  // One more entry than values, for everything out of range
+  static constexpr std::size_t dense_size = dense ? span + 2 : 1;
+  static constexpr std::size_t sparse_size = dense ? 1 : count;
+
+  static constexpr constexpr_array<index_type<T>, dense_size> dense_table =
+      make_dense_index<T, dense_size>();
+  static constexpr constexpr_array<sorted_entry<T>, sparse_size> sparse_table =
+      make_sparse_index<T, sparse_size>();
+
+  static constexpr std::size_t lookup(T t) {
+    if (dense) {
+      const auto offset = to_uint64(t) - min;
+      return dense_table[offset < span + 1 ? offset : span + 1];
+    }
+    const auto v = static_cast<std::underlying_type_t<T>>(t);
+    std::size_t first = 0;
+    std::size_t len = count;
+    while (len != 0) {
+      const auto half = len / 2;
+      if (sparse_table[first + half].value < v) {
+        first += half + 1;
+        len -= half + 1;
+      } else {
+        len = half;
+      }
+    }
+    return first != count && sparse_table[first].value == v
+               ? sparse_table[first].index
+               : count;
+  }
+};
+
+template <class T>
+constexpr constexpr_array<index_type<T>, index_table<T>::dense_size>
+    index_table<T>::dense_table;
+template <class T>
+constexpr constexpr_array<sorted_entry<T>, index_table<T>::sparse_size>
+    index_table<T>::sparse_table;
+
+template <class T>
+constexpr constexpr_array<T, enumerators<T>::size> make_values() {
+  constexpr_array<T, enumerators<T>::size> a{};
+  for (std::size_t i = 0; i != enumerators<T>::size; ++i)
+    a[i] = enumerators<T>::range[i].value;
+  return a;
+}
+
+// Just the values of range<T>, packed tightly; the inverse of index_of
+template <class T>
+struct value_table {
+  static constexpr constexpr_array<T, enumerators<T>::size> values =
+      make_values<T>();
+};
+
+template <class T>
+constexpr constexpr_array<T, enumerators<T>::size> value_table<T>::values;
+
+} // namespace detail
+
+// Returns the position of an enumerator in the declared order, i.e. the index
+// into range<T> that holds it. If t is not an enumerator, returns size<T>.
+template <class T>
+constexpr std::size_t index_of(T t) {
+  return detail::index_table<T>::lookup(t);
+}
+
+// False for an enumerator with the same value as an earlier one (an alias):
+// index_of never returns its ordinal, but that of the first one
+template <class T>
+constexpr bool is_canonical_ordinal(std::size_t i) {
+  return index_of(range<T>[i].value) == i;
+}
+
+// The enumerator at ordinal I, as a type: an std::integral_constant, so that
+// its value can be used as a template argument
+template <class T, std::size_t I>
+using enumerator_constant =
+    std::integral_constant<T, detail::value_table<T>::values[I]>;
+
+namespace detail {
+
+template <class T, class F, std::size_t... I>
+constexpr void for_each(F &f, std::index_sequence<I...>) {
+  // Elements of a braced initializer are evaluated in order
+  const int expand[] = {
+      0, (static_cast<void>(f(enumerator_constant<T, I>{}, range<T>[I].name)),
+          0)...};
+  static_cast<void>(expand);
+}
+
+} // namespace detail
+
+// Calls f(enumerator_constant<T, I>{}, name) for every enumerator, in the
+// declared order. The calls are expanded at compile time rather than looping
+// over range, so each one sees its enumerator as a constant, and can e.g.
+// instantiate templates with it.
+template <class T, class F>
+constexpr void for_each(F &&f) {
+  detail::for_each<T>(f, std::make_index_sequence<size<T>>{});
+}
+#endif
+} // namespace wise_enum
+
+#include <limits>
 #include <type_traits>
 
 namespace wise_enum {
@@ -1229,6 +1518,80 @@ constexpr bool is_enum_value(std::underlying_type_t<T> enum_integral) {
   return false;
 }
 
+namespace detail {
+
+// Scoped enums always have a fixed underlying type. Unscoped ones may or may
+// not; in 17 the ones that do could be told apart, but not in 14, so they are
+// all assumed not to have one. The rule must not depend on the standard, or
+// the default sentinel, and so the type of a compact_optional, would differ
+// between 14 and 17 translation units.
+template <class T>
+struct has_fixed_underlying_type
+    : std::integral_constant<
+          bool, !std::is_convertible<T, std::underlying_type_t<T>>::value> {};
+
+// All bits below and including the highest set bit of v
+template <class U>
+constexpr U smear(U v) {
+  for (std::size_t shift = 1; shift < sizeof(U) * 8; shift *= 2)
+    v |= v >> shift;
+  return v;
+}
+
+template <class U>
+struct value_interval {
+  U min;
+  U max;
+};
+
+// The values an enum can legally hold: the whole underlying type if it is
+// fixed, otherwise the values of the smallest bit-field that fits every
+// enumerator
+template <class T>
+constexpr value_interval<std::underlying_type_t<T>> valid_values() {
+  using U = std::underlying_type_t<T>;
+  if (has_fixed_underlying_type<T>::value)
+    return {std::numeric_limits<U>::min(), std::numeric_limits<U>::max()};
+  const U lo = min_value<T>();
+  const U hi = max_value<T>();
+  if (lo >= 0)
+    return {0, static_cast<U>(smear(hi) | 1)};
+  // Two's complement bit-field: the magnitude of lo is ~lo + 1
+  const auto neg = static_cast<U>(~lo);
+  const U m = smear(hi > neg ? hi : neg);
+  return {static_cast<U>(~m), m};
+}
+
+template <class U>
+struct sentinel_search {
+  bool found;
+  U value;
+};
+
+// The largest value of the underlying type if it isn't an enumerator, which
+// was always the default, so that existing compact_optionals keep their type
+// and encoding. Otherwise, the largest valid value that isn't an enumerator:
+// out of any size<T> + 1 distinct values at least one is free, so only that
+// many are looked at.
+template <class T>
+constexpr sentinel_search<std::underlying_type_t<T>> find_sentinel() {
+  using U = std::underlying_type_t<T>;
+  if (!is_enum_value<T>(std::numeric_limits<U>::max()))
+    return {true, std::numeric_limits<U>::max()};
+  const auto r = valid_values<T>();
+  auto v = r.max;
+  for (std::size_t i = 0; i <= size<T>; ++i) {
+    if (!is_enum_value<T>(v))
+      return {true, v};
+    if (v == r.min)
+      break;
+    v = static_cast<decltype(v)>(v - 1);
+  }
+  return {false, r.max};
+}
+
+} // namespace detail
+
 /*
   Implementation note: this doesn't exactly implement the subset of the optional
   interface correctly, in particular operator* and value return by value. This
@@ -1251,17 +1614,34 @@ constexpr bool is_enum_value(std::underlying_type_t<T> enum_integral) {
   behavior and normal optional will mostly be caught at compile time (e.g. *foo
   = MyEnum::BAR will not compile for compact optional). None of the
   discrepancies are critical to usage.
+
+   By default the sentinel is the largest value of the underlying type; as it's
+  only ever stored in an integral_type, it doesn't matter whether the enum can
+  hold it. Only if that value is an enumerator is another one picked at
+  compile time: the largest value that isn't an enumerator and that the enum
+  can legally hold. That is, within the whole underlying type for enum
+  classes, and within the bitset range above for unscoped enums, even those
+  with explicit storage (they can't be told apart in 14, and the choice must
+  be the same in every standard). If there is none, compilation fails.
  */
 template <class T, std::underlying_type_t<T> invalid =
-                       std::numeric_limits<std::underlying_type_t<T>>::max()>
+                       detail::find_sentinel<T>().value>
 class compact_optional {
 
   using integral_type = std::underlying_type_t<T>;
 
   static_assert(is_wise_enum_v<T>,
                 "wise enum compact_optional is only for wise enum types");
+  // True if invalid is the default, and there was no sentinel to pick
+  static constexpr bool no_sentinel = !detail::find_sentinel<T>().found &&
+                                      invalid == detail::find_sentinel<T>().value;
+
+  static_assert(!no_sentinel,
+                "Error, every value this enum can hold is an enumerator, so "
+                "there is no sentinel for compact_optional to use; consider "
+                "compact_ordinal_optional");
   static_assert(
-      !is_enum_value<T>(invalid),
+      no_sentinel || !is_enum_value<T>(invalid),
       "Error, can't use this invalid value as it is taken by an enumerator");
 
 public:
@@ -1302,4 +1682,70 @@ private:
   integral_type m_storage = invalid;
 };
 
+/*
+  A compact optional that doesn't store the enum itself, but its ordinal (its
+  index in range<T>), in the smallest unsigned integral type that fits
+  size<T> + 1 values; the extra value, size<T>, means empty. An enum with 64
+  bit storage but less than 256 enumerators thus takes a single byte.
+  Conversion in either direction is a table lookup.
+
+  Unlike compact_optional, no sentinel needs to be chosen, but only
+  enumerators can be stored: constructing it from any other value results in
+  an empty optional. The same caveats as for compact_optional apply to the
+  interface (operator* and value return by value).
+ */
+template <class T>
+class compact_ordinal_optional {
+
+  using storage_type = detail::smallest_uint_t<size<T>>;
+
+  static_assert(
+      is_wise_enum_v<T>,
+      "wise enum compact_ordinal_optional is only for wise enum types");
+
+  static constexpr storage_type empty = size<T>;
+
+public:
+  compact_ordinal_optional() = default;
+
+  constexpr compact_ordinal_optional(T t)
+      : m_storage(static_cast<storage_type>(index_of(t))) {}
+
+  constexpr T operator*() const {
+    return detail::value_table<T>::values[m_storage];
+  }
+
+  constexpr bool has_value() const noexcept { return m_storage != empty; }
+  constexpr explicit operator bool() const noexcept {
+    return m_storage != empty;
+  }
+
+  constexpr T value() const {
+    if (m_storage != empty)
+      return detail::value_table<T>::values[m_storage];
+    else
+      throw bad_optional_access{};
+  }
+
+  template <class U>
+  constexpr T value_or(U &&u) const {
+    if (has_value())
+      return detail::value_table<T>::values[m_storage];
+    else
+      return std::forward<U>(u);
+  }
+
+  void reset() noexcept { m_storage = empty; }
+
+  compact_ordinal_optional(const compact_ordinal_optional &other) = default;
+  compact_ordinal_optional(compact_ordinal_optional &&other) = default;
+  compact_ordinal_optional &
+  operator=(const compact_ordinal_optional &other) = default;
+  compact_ordinal_optional &
+  operator=(compact_ordinal_optional &&other) = default;
+
+private:
+  storage_type m_storage = empty;
+};
+
 } // namespace wise_enum
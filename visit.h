@@ -0,0 +1,231 @@
+#pragma once
+
+#include "wise_enum.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// The largest number of enumerator combinations (the product of the sizes of
+// the enums) that a multi enum visit will generate a table for. Every
+// combination instantiates the visitor, so this bounds compile times.
+#ifndef WISE_ENUM_MAX_VISIT_PRODUCT
+#define WISE_ENUM_MAX_VISIT_PRODUCT 1024
+#endif
+
+namespace wise_enum {
+
+namespace detail {
+
+template <class F, class T, std::size_t I>
+using visit_arm_result_t =
+    decltype(std::declval<F>()(enumerator_constant<T, I>{}));
+
+template <bool... B>
+using all_true = std::is_same<std::integer_sequence<bool, true, B...>,
+                              std::integer_sequence<bool, B..., true>>;
+
+template <class F, class T, class Indices>
+struct visit_result;
+
+template <class F, class T, std::size_t... I>
+struct visit_result<F, T, std::index_sequence<I...>> {
+  using type = visit_arm_result_t<F, T, 0>;
+  static constexpr bool consistent = all_true<
+      std::is_same<type, visit_arm_result_t<F, T, I>>::value...>::value;
+};
+
+constexpr std::size_t max_of(std::initializer_list<std::size_t> l) {
+  std::size_t m = 0;
+  for (auto x : l) {
+    if (x > m)
+      m = x;
+  }
+  return m;
+}
+
+// Properties of the types a class template maps enumerators to, such as the
+// Mapping of enum_object and enum_variant
+template <class E, template <E> class Mapping, std::size_t... I>
+constexpr std::size_t max_mapped_size(std::index_sequence<I...>) {
+  return max_of({sizeof(Mapping<value_table<E>::values[I]>)...});
+}
+
+template <class E, template <E> class Mapping, std::size_t... I>
+constexpr std::size_t max_mapped_alignment(std::index_sequence<I...>) {
+  return max_of({alignof(Mapping<value_table<E>::values[I]>)...});
+}
+
+template <class E, class Base, template <E> class Mapping, std::size_t... I>
+constexpr bool all_mapped_derive_from(std::index_sequence<I...>) {
+  return all_true<std::is_base_of<
+      Base, Mapping<value_table<E>::values[I]>>::value...>::value;
+}
+
+template <class R>
+struct throw_on_invalid {
+  template <class T>
+  R operator()(T) const {
+    throw std::out_of_range("Error, visited value is not an enumerator");
+  }
+};
+
+template <class R, class T, std::size_t I, class F, class G>
+R visit_arm(T, F &f, G &) {
+  return static_cast<F &&>(f)(enumerator_constant<T, I>{});
+}
+
+template <class R, class T, class F, class G>
+R visit_invalid(T t, F &, G &g) {
+  return static_cast<G &&>(g)(t);
+}
+
+template <class R, class T, class F, class G, std::size_t... I>
+R visit(T t, F &f, G &g, std::index_sequence<I...>) {
+  // One entry per ordinal, plus one for index_of's "not an enumerator"
+  using arm = R (*)(T, F &, G &);
+  static constexpr arm table[] = {&visit_arm<R, T, I, F, G>...,
+                                  &visit_invalid<R, T, F, G>};
+  return table[index_of(t)](t, f, g);
+}
+
+/*
+  Visiting several enums at once: the combination of ordinals (i0, i1, ...) is
+  flattened, row major, into a single index into one table with an entry per
+  combination.
+ */
+template <class F, class... Ts>
+struct multi_visitor {
+  static constexpr std::size_t count = sizeof...(Ts);
+
+  static constexpr std::size_t product() {
+    const std::size_t sizes[] = {size<Ts>...};
+    std::size_t p = 1;
+    for (std::size_t j = 0; j != count; ++j)
+      p *= sizes[j];
+    return p;
+  }
+
+  // The ordinal of the j-th enum in combination k
+  static constexpr std::size_t ordinal(std::size_t k, std::size_t j) {
+    const std::size_t sizes[] = {size<Ts>...};
+    for (std::size_t i = count - 1; i != j; --i)
+      k /= sizes[i];
+    return k % sizes[j];
+  }
+
+  template <std::size_t K, std::size_t... J>
+  static auto call(F &f, std::index_sequence<J...>)
+      -> decltype(std::declval<F>()(
+          enumerator_constant<Ts, ordinal(K, J)>{}...)) {
+    return static_cast<F &&>(f)(enumerator_constant<Ts, ordinal(K, J)>{}...);
+  }
+
+  template <std::size_t K>
+  using arm_result_t =
+      decltype(call<K>(std::declval<F &>(), std::index_sequence_for<Ts...>{}));
+
+  template <class R, std::size_t K>
+  static R arm(F &f) {
+    return call<K>(f, std::index_sequence_for<Ts...>{});
+  }
+
+  template <class R, std::size_t... K>
+  static R dispatch(std::size_t flat, F &f, std::index_sequence<K...>) {
+    static_assert(
+        all_true<std::is_same<R, arm_result_t<K>>::value...>::value,
+        "Error, visitor must return the same type for all combinations");
+    using fn = R (*)(F &);
+    static constexpr fn table[] = {&arm<R, K>...};
+    return table[flat](f);
+  }
+};
+
+} // namespace detail
+
+/*
+  Lifts a runtime enum value into a compile time constant: calls f with
+  enumerator_constant<T, index_of(t)>, which converts to T, and whose ::value
+  can be used as a template argument. E.g.
+
+    std::unique_ptr<Base> make(MyEnum e) {
+      return wise_enum::visit(e, [](auto c) -> std::unique_ptr<Base> {
+        return std::make_unique<Derived<c.value>>();
+      });
+    }
+
+  f must return the same type for every enumerator. Dispatch is a single
+  indirect call through a table built at compile time, indexed by the ordinal,
+  with one function per enumerator, each of which the compiler can inline f
+  into.
+
+  If t isn't an enumerator, on_invalid(t) is called instead; it must return
+  the same type as f. Without it, std::out_of_range is thrown.
+ */
+template <class T, class F, class G,
+          std::enable_if_t<is_wise_enum_v<T>, int> = 0>
+decltype(auto) visit(T t, F &&f, G &&on_invalid) {
+  using indices = std::make_index_sequence<size<T>>;
+  using result = detail::visit_result<F, T, indices>;
+  static_assert(result::consistent,
+                "Error, visitor must return the same type for all enumerators");
+  // F and G are passed explicitly, so that f and on_invalid are called with
+  // the value category they were given with
+  return detail::visit<typename result::type, T, F, G>(t, f, on_invalid,
+                                                       indices{});
+}
+
+template <class T, class F, std::enable_if_t<is_wise_enum_v<T>, int> = 0>
+decltype(auto) visit(T t, F &&f) {
+  using R = typename detail::visit_result<
+      F, T, std::make_index_sequence<size<T>>>::type;
+  return ::wise_enum::visit(t, std::forward<F>(f),
+                            detail::throw_on_invalid<R>{});
+}
+
+/*
+  Visits the combination of several enum values at once: f is called with one
+  enumerator_constant per enum, e.g.
+
+    wise_enum::visit([](auto type, auto op, auto layout) {
+      run_kernel<type.value, op.value, layout.value>();
+    }, type, op, layout);
+
+  The ordinals are combined into a single flat index into one table, generated
+  at compile time, with an entry for every combination; dispatch is still a
+  single indirect call. As every combination instantiates f, the product of
+  the sizes of the enums may not exceed WISE_ENUM_MAX_VISIT_PRODUCT (which may
+  be defined before including this header). f must return the same type for
+  every combination. If any of the values isn't an enumerator,
+  std::out_of_range is thrown.
+ */
+template <class F, class T, class... Ts,
+          std::enable_if_t<!is_wise_enum_v<std::decay_t<F>>, int> = 0>
+decltype(auto) visit(F &&f, T t, Ts... ts) {
+  static_assert(
+      detail::all_true<is_wise_enum_v<T>, is_wise_enum_v<Ts>...>::value,
+      "visit is only for wise enum types");
+  using visitor = detail::multi_visitor<F, T, Ts...>;
+  constexpr auto product = visitor::product();
+  static_assert(product <= WISE_ENUM_MAX_VISIT_PRODUCT,
+                "Error, too many combinations of enumerators to visit; the "
+                "limit is WISE_ENUM_MAX_VISIT_PRODUCT");
+  using R = typename visitor::template arm_result_t<0>;
+
+  const std::size_t sizes[] = {size<T>, size<Ts>...};
+  const std::size_t ordinals[] = {index_of(t), index_of(ts)...};
+  std::size_t flat = 0;
+  for (std::size_t j = 0; j != visitor::count; ++j) {
+    if (ordinals[j] == sizes[j])
+      throw std::out_of_range("Error, visited value is not an enumerator");
+    flat = flat * sizes[j] + ordinals[j];
+  }
+  // Past the limit, don't instantiate anything beyond the static_assert
+  using combinations = std::make_index_sequence<
+      product <= WISE_ENUM_MAX_VISIT_PRODUCT ? product : 1>;
+  return visitor::template dispatch<R>(flat, f, combinations{});
+}
+
+} // namespace wise_enum
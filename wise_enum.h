@@ -105,4 +105,204 @@ WISE_ENUM_CONSTEXPR_14 optional_type<T> from_string(string_type s) {
 
   return it->value;
 }
+
+#if __cplusplus >= 201402
+namespace detail {
+
+template <class T>
+constexpr std::underlying_type_t<T> min_value() {
+  const auto &r = enumerators<T>::range;
+  auto m = static_cast<std::underlying_type_t<T>>(r[0].value);
+  for (std::size_t i = 1; i != r.size(); ++i) {
+    if (static_cast<std::underlying_type_t<T>>(r[i].value) < m)
+      m = static_cast<std::underlying_type_t<T>>(r[i].value);
+  }
+  return m;
+}
+
+template <class T>
+constexpr std::underlying_type_t<T> max_value() {
+  const auto &r = enumerators<T>::range;
+  auto m = static_cast<std::underlying_type_t<T>>(r[0].value);
+  for (std::size_t i = 1; i != r.size(); ++i) {
+    if (static_cast<std::underlying_type_t<T>>(r[i].value) > m)
+      m = static_cast<std::underlying_type_t<T>>(r[i].value);
+  }
+  return m;
+}
+
+// Number of distinct integral values between the smallest and the largest
+// enumerator, minus one
+template <class T>
+constexpr std::uint64_t value_span() {
+  return to_uint64(static_cast<T>(max_value<T>())) -
+         to_uint64(static_cast<T>(min_value<T>()));
+}
+
+template <class T>
+constexpr bool is_dense() {
+  return value_span<T>() < 4 * enumerators<T>::size;
+}
+
+template <class T>
+using index_type = smallest_uint_t<enumerators<T>::size>;
+
+template <class T>
+struct sorted_entry {
+  std::underlying_type_t<T> value;
+  index_type<T> index;
+};
+
+template <class T, std::size_t N>
+constexpr constexpr_array<index_type<T>, N> make_dense_index() {
+  constexpr_array<index_type<T>, N> a{};
+  for (std::size_t i = 0; i != N; ++i)
+    a[i] = enumerators<T>::size;
+  if (is_dense<T>()) {
+    // iterate backwards, so that duplicate values map to the first one
+    for (std::size_t i = enumerators<T>::size; i != 0; --i) {
+      a[to_uint64(enumerators<T>::range[i - 1].value) -
+        to_uint64(static_cast<T>(min_value<T>()))] =
+          static_cast<index_type<T>>(i - 1);
+    }
+  }
+  return a;
+}
+
+template <class T, std::size_t N>
+constexpr constexpr_array<sorted_entry<T>, N> make_sparse_index() {
+  constexpr_array<sorted_entry<T>, N> a{};
+  if (!is_dense<T>()) {
+    // insertion sort; stable, so duplicate values map to the first one
+    for (std::size_t i = 0; i != N; ++i) {
+      sorted_entry<T> e{
+          static_cast<std::underlying_type_t<T>>(enumerators<T>::range[i].value),
+          static_cast<index_type<T>>(i)};
+      std::size_t j = i;
+      for (; j != 0 && e.value < a[j - 1].value; --j)
+        a[j] = a[j - 1];
+      a[j] = e;
+    }
+  }
+  return a;
+}
+
+/*
+  Compile time tables mapping an enumerator to its position in the declared
+  order. If the values of the enum are reasonably tightly packed, the value
+  (minus the smallest value) directly indexes a table, which makes the lookup a
+  subtraction, a min and a load: out of range offsets are clamped to an extra
+  last entry holding count, so there is no branch, and loops over it can be
+  vectorized. Otherwise (e.g. bit flags) we fall
+  back to a binary search over the values sorted at compile time, so memory use
+  stays proportional to the number of enumerators.
+ */
+template <class T>
+struct index_table {
+  static constexpr std::size_t count = enumerators<T>::size;
+  static constexpr bool dense = is_dense<T>();
+  static constexpr std::uint64_t span = value_span<T>();
+  static constexpr std::uint64_t min = to_uint64(static_cast<T>(min_value<T>()));
+
+  // One more entry than values, for everything out of range
+  static constexpr std::size_t dense_size = dense ? span + 2 : 1;
+  static constexpr std::size_t sparse_size = dense ? 1 : count;
+
+  static constexpr constexpr_array<index_type<T>, dense_size> dense_table =
+      make_dense_index<T, dense_size>();
+  static constexpr constexpr_array<sorted_entry<T>, sparse_size> sparse_table =
+      make_sparse_index<T, sparse_size>();
+
+  static constexpr std::size_t lookup(T t) {
+    if (dense) {
+      const auto offset = to_uint64(t) - min;
+      return dense_table[offset < span + 1 ? offset : span + 1];
+    }
+    const auto v = static_cast<std::underlying_type_t<T>>(t);
+    std::size_t first = 0;
+    std::size_t len = count;
+    while (len != 0) {
+      const auto half = len / 2;
+      if (sparse_table[first + half].value < v) {
+        first += half + 1;
+        len -= half + 1;
+      } else {
+        len = half;
+      }
+    }
+    return first != count && sparse_table[first].value == v
+               ? sparse_table[first].index
+               : count;
+  }
+};
+
+template <class T>
+constexpr constexpr_array<index_type<T>, index_table<T>::dense_size>
+    index_table<T>::dense_table;
+template <class T>
+constexpr constexpr_array<sorted_entry<T>, index_table<T>::sparse_size>
+    index_table<T>::sparse_table;
+
+template <class T>
+constexpr constexpr_array<T, enumerators<T>::size> make_values() {
+  constexpr_array<T, enumerators<T>::size> a{};
+  for (std::size_t i = 0; i != enumerators<T>::size; ++i)
+    a[i] = enumerators<T>::range[i].value;
+  return a;
+}
+
+// Just the values of range<T>, packed tightly; the inverse of index_of
+template <class T>
+struct value_table {
+  static constexpr constexpr_array<T, enumerators<T>::size> values =
+      make_values<T>();
+};
+
+template <class T>
+constexpr constexpr_array<T, enumerators<T>::size> value_table<T>::values;
+
+} // namespace detail
+
+// Returns the position of an enumerator in the declared order, i.e. the index
+// into range<T> that holds it. If t is not an enumerator, returns size<T>.
+template <class T>
+constexpr std::size_t index_of(T t) {
+  return detail::index_table<T>::lookup(t);
+}
+
+// False for an enumerator with the same value as an earlier one (an alias):
+// index_of never returns its ordinal, but that of the first one
+template <class T>
+constexpr bool is_canonical_ordinal(std::size_t i) {
+  return index_of(range<T>[i].value) == i;
+}
+
+// The enumerator at ordinal I, as a type: an std::integral_constant, so that
+// its value can be used as a template argument
+template <class T, std::size_t I>
+using enumerator_constant =
+    std::integral_constant<T, detail::value_table<T>::values[I]>;
+
+namespace detail {
+
+template <class T, class F, std::size_t... I>
+constexpr void for_each(F &f, std::index_sequence<I...>) {
+  // Elements of a braced initializer are evaluated in order
+  const int expand[] = {
+      0, (static_cast<void>(f(enumerator_constant<T, I>{}, range<T>[I].name)),
+          0)...};
+  static_cast<void>(expand);
+}
+
+} // namespace detail
+
+// Calls f(enumerator_constant<T, I>{}, name) for every enumerator, in the
+// declared order. The calls are expanded at compile time rather than looping
+// over range, so each one sees its enumerator as a constant, and can e.g.
+// instantiate templates with it.
+template <class T, class F>
+constexpr void for_each(F &&f) {
+  detail::for_each<T>(f, std::make_index_sequence<size<T>>{});
+}
+#endif
 } // namespace wise_enum
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 
@@ -92,6 +94,92 @@ template <class U, class = typename std::enable_if<
 WISE_ENUM_CONSTEXPR_14 bool compare(U u1, U u2) {
   return u1 == u2;
 }
+
+// Characters and length of a string_type, whichever it is
+inline const char *str_data(const char *s) { return s; }
+inline std::size_t str_size(const char *s) {
+  std::size_t n = 0;
+  while (s[n])
+    ++n;
+  return n;
+}
+
+template <class U, class = typename std::enable_if<
+                       !std::is_same<U, const char *>::value>::type>
+const char *str_data(const U &s) {
+  return s.data();
+}
+template <class U, class = typename std::enable_if<
+                       !std::is_same<U, const char *>::value>::type>
+std::size_t str_size(const U &s) {
+  return s.size();
+}
+
+// FNV-1a; names are short, so hashing costs about as much as finding the
+// length of a C string
+inline std::uint32_t name_hash(const char *p, std::size_t n) {
+  std::uint32_t h = 2166136261u;
+  for (std::size_t i = 0; i != n; ++i) {
+    h ^= static_cast<unsigned char>(p[i]);
+    h *= 16777619u;
+  }
+  return h;
+}
+
+#if __cplusplus >= 201402
+// Smallest unsigned integral type able to hold every value in [0, N]
+template <std::uint64_t N>
+using smallest_uint_t = std::conditional_t<
+    N <= 0xFF, std::uint8_t,
+    std::conditional_t<N <= 0xFFFF, std::uint16_t,
+                       std::conditional_t<N <= 0xFFFFFFFF, std::uint32_t,
+                                          std::uint64_t>>>;
+
+// std::array's mutating members are not constexpr until 17, which makes it
+// useless for building lookup tables at compile time in 14. This is the bare
+// minimum needed for that.
+template <class V, std::size_t N>
+struct constexpr_array {
+  V data[N];
+
+  constexpr V &operator[](std::size_t i) { return data[i]; }
+  constexpr const V &operator[](std::size_t i) const { return data[i]; }
+  static constexpr std::size_t size() { return N; }
+};
+
+// Reinterprets the value of an enumerator as a 64 bit unsigned integer. Values
+// are sign extended first, so differences between two converted values of the
+// same enum are always the correct (wrapping) unsigned distance
+template <class T>
+constexpr std::uint64_t to_uint64(T t) {
+  return static_cast<std::uint64_t>(
+      static_cast<typename std::underlying_type<T>::type>(t));
+}
+
+// Bit manipulation helpers, as found in <bit> in 20
+constexpr int popcount(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & 0x5555555555555555u);
+  x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+  return static_cast<int>((x * 0x0101010101010101u) >> 56);
+#endif
+}
+
+// x must not be 0
+constexpr int countr_zero(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+  for (; !(x & 1); x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+#endif
 } // namespace detail
 } // namespace wise_enum
 